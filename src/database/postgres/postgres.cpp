@@ -35,6 +35,8 @@ std::vector<player::PlayerRecord> RetiredPlayersRepositoryImpl::GetPlayersRecord
 
 //__________ConnectionPool__________
 ConnectionPool::ConnectionWrapper ConnectionPool::GetConnection() {
+    const auto start = Clock::now();
+
     std::unique_lock lock{mutex_};
     // Блокируем текущий поток и ждём, пока cond_var_ не получит уведомление и не освободится
     // хотя бы одно соединение
@@ -43,7 +45,20 @@ ConnectionPool::ConnectionWrapper ConnectionPool::GetConnection() {
     });
     // После выхода из цикла ожидания мьютекс остаётся захваченным
 
-    return {std::move(pool_[used_connections_++]), *this};
+    ConnectionWrapper connection{std::move(pool_[used_connections_++]), *this};
+    auto observer = wait_observer_;
+    lock.unlock();
+
+    if(observer) {
+        observer(Clock::now() - start);
+    }
+
+    return connection;
+}
+
+void ConnectionPool::SetWaitObserver(WaitObserver observer) {
+    std::lock_guard lock{mutex_};
+    wait_observer_ = std::move(observer);
 }
 
 void ConnectionPool::ReturnConnection(ConnectionPtr&& conn) {
@@ -105,4 +120,8 @@ app_database::UnitOfWorkFactory &Database::GetUnitOfWorkFactory()  {
     return unit_factory_;
 }
 
+void Database::SetConnectionWaitObserver(ConnectionPool::WaitObserver observer) {
+    connection_pool_.SetWaitObserver(std::move(observer));
+}
+
 } // namespace postgres
\ No newline at end of file
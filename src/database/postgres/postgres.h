@@ -3,7 +3,9 @@
 #include <pqxx/connection>
 #include <pqxx/transaction>
 
+#include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -75,7 +77,12 @@ public:
         }
     }
 
+    using Clock = std::chrono::steady_clock;
+    //Вызывается после получения соединения с временем ожидания свободного соединения
+    using WaitObserver = std::function<void(Clock::duration)>;
+
     ConnectionWrapper GetConnection();
+    void SetWaitObserver(WaitObserver observer);
 
 private:
     void ReturnConnection(ConnectionPtr&& conn);
@@ -84,6 +91,7 @@ private:
     std::condition_variable cond_var_;
     std::vector<ConnectionPtr> pool_;
     size_t used_connections_ = 0;
+    WaitObserver wait_observer_;
 };
 
 class UnitOfWorkImpl : public app_database::UnitOfWork {
@@ -114,6 +122,7 @@ public:
     explicit Database(DatabaseConfig&& config);
   
     app_database::UnitOfWorkFactory& GetUnitOfWorkFactory();
+    void SetConnectionWaitObserver(ConnectionPool::WaitObserver observer);
 private:
     ConnectionPool connection_pool_;
     UnitOfWorkFactoryImpl unit_factory_{connection_pool_};
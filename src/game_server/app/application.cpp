@@ -1,5 +1,7 @@
 #include <stdexcept>
 
+#include "../server/etag.h"
+#include "../server/metrics.h"
 #include "application.h"
 
 namespace app {
@@ -18,6 +20,9 @@ const static string_view CONTENT_TYPE = "Content-Type";
 Application::Application(postgres::DatabaseConfig&& config)
     : db_(std::make_unique<postgres::Database>(std::move(config)))
     , use_cases_(std::make_unique<app_database::UseCasesImpl>(db_->GetUnitOfWorkFactory())) {
+    db_->SetConnectionWaitObserver([](postgres::ConnectionPool::Clock::duration wait) {
+        metrics::GetServerMetrics().ObserveConnectionWait(wait);
+    });
 }
 
 ResponseInfo Application::JoinGame(const string& req_body) {
@@ -79,36 +84,56 @@ ResponseInfo Application::UpdateState(const Header& header, const string& req_bo
     });
 }
 
-ResponseInfo Application::ProcessTickActions(const Header& header, const string& req_body) {
+std::variant<std::chrono::milliseconds, ResponseInfo> Application::ParseTickRequest(const Header& header, 
+                                                                                    const string& req_body) const {
     if(auto content = FindHeader(header, CONTENT_TYPE); !content.has_value()
                                                         && *content != ContentType::APPLICATION_JSON) {
-        return {http::status::bad_request,
-                MakeBodyErrorJSON(TargetErrorCode::ERROR_INVALID_ARGUMENT_CODE,
-                                  TargetErrorMessage::ERROR_INVALID_CONTENT_MESSAGE)};                                                 
+        return ResponseInfo {http::status::bad_request,
+                             MakeBodyErrorJSON(TargetErrorCode::ERROR_INVALID_ARGUMENT_CODE,
+                                               TargetErrorMessage::ERROR_INVALID_CONTENT_MESSAGE)};                                                 
     }
 
     if(auto time = json_loader::LoadTickInfo(req_body)) {
-        auto time_delta = std::chrono::milliseconds(time.value());
-        ProcessTickActions(time_delta);
-    } else {
-        return ResponseInfo {http::status::bad_request,
-                             MakeBodyErrorJSON(TargetErrorCode::ERROR_INVALID_ARGUMENT_CODE,
-                                               TargetErrorMessage::ERROR_INVALID_TICK_PARSE_MESSAGE)};
+        return std::chrono::milliseconds(time.value());
+    }
+
+    return ResponseInfo {http::status::bad_request,
+                         MakeBodyErrorJSON(TargetErrorCode::ERROR_INVALID_ARGUMENT_CODE,
+                                           TargetErrorMessage::ERROR_INVALID_TICK_PARSE_MESSAGE)};
+}
+
+std::vector<PlayerRecord> Application::ProcessSessionTick(GameSession& session, const std::chrono::milliseconds& delta,
+                                                          model::TickPhasesDuration* phases) {
+    session.ProcessTickActions(delta, phases);
+
+    std::vector<PlayerRecord> records;
+    {
+        model::ScopedTickPhase phase(phases, model::TickPhase::SEND_INTO_RETIREMENT);
+        records = players_->SendIntoRetirement(session, game_->GetRetirementTime());
     }
 
-    return ResponseInfo {http::status::ok,
-                         MakeBodyEmptyObject()};
+    //Снимок публикуется один раз за тик, уже без отправленных на пенсию собак
+    model::ScopedTickPhase phase(phases, model::TickPhase::PUBLISH_SNAPSHOT);
+    session.PublishSnapshotIfChanged();
+
+    return records;
 }
 
-void Application::ProcessTickActions(const std::chrono::milliseconds& delta) {
-    game_->ProcessTickActions(delta);
-    auto retirement_players = players_->SendIntoRetirement(game_->GetRetirementTime());
+void Application::PublishSessionChanges(const model::Map::Id& map_id) {
+    if(auto session = game_->FindGameSessionById(map_id)) {
+        session->PublishSnapshotIfChanged();
+    }
+}
 
-    if(!retirement_players.empty()) {
-        SetRecords(retirement_players);
+void Application::FinishTick(const std::vector<PlayerRecord>& records, const std::chrono::milliseconds& delta,
+                             model::TickPhasesDuration* phases) {
+    if(!records.empty()) {
+        model::ScopedTickPhase phase(phases, model::TickPhase::SET_RECORDS);
+        SetRecords(records);
     }
 
     if(listener_) {
+        model::ScopedTickPhase phase(phases, model::TickPhase::ON_TICK);
         listener_->OnTick(delta);
     }
 }
@@ -117,52 +142,73 @@ const player::Player* Application::FindPlayerByToken(const player::Token& token)
     return players_->FindPlayerByToken(token).value();
 }
 
+optional<Map::Id> Application::FindPlayerMapId(const Header& header) const {
+    if(auto token = TryExtractToken(header)) {
+        return players_->FindPlayerMapId(Token(*token));
+    }
+
+    return std::nullopt;
+}
+
+ResponseInfo Application::MakeUnknownPlayerInfo(const Header& header) const {
+    return ExecuteAuthorized(header, []([[maybe_unused]] const string& token) {
+        return ResponseInfo{http::status::unauthorized,
+                            MakeBodyErrorJSON(TargetErrorCode::ERROR_SEARCH_TOKEN_CODE,
+                                              TargetErrorMessage::ERROR_SEARCH_TOKEN_MESSAGE)};
+    });
+}
+
 void Application::SetGame(model::Game&& game)  {
     game_ = std::make_unique<model::Game>(std::forward<model::Game>(game));
+    game_->AddMissingSessions();
 }
 
 void Application::SetListener(std::unique_ptr<ApplicationListener> listener) {
     listener_ = std::move(listener);
 }
 
-ResponseInfo Application::GetStaticObjectsInfo(TargetRequestType req_type, 
-                                               const string& req_obj,
-                                               const extra_data::LootTypes& types) const {
-    ResponseInfo resp_info;
+void Application::PrepareMapResponses(const extra_data::LootTypes& types) {
+    map_responses_ = MapResponses(*game_, types);
+}
 
+ResponseInfo Application::GetStaticObjectsInfo(const string& req_obj) const {
     if(req_obj.empty()) {
-        resp_info.status = http::status::ok;
-        resp_info.body = MakeBodyJSON(req_type, *game_);
-
-        return resp_info;
+        const auto& maps_info = map_responses_.GetMapsInfo();
+        return {http::status::ok, {}, maps_info.etag, maps_info.body};
     }
 
-    if(!(game_->FindMap(Map::Id{req_obj}))) {
-        resp_info.status = http::status::not_found;
-    } else {
-        resp_info.status = http::status::ok;
+    if(const auto* map = map_responses_.FindMap(Map::Id{req_obj})) {
+        return {http::status::ok, {}, map->etag, map->body};
     }
-    resp_info.body = MakeBodyJSON(req_type, *game_, req_obj, types.GetTypes(Map::Id(req_obj)));
 
-    return resp_info;
+    return {http::status::not_found,
+            MakeBodyErrorJSON(TargetErrorCode::ERROR_SEARCH_MAP_CODE,
+                              TargetErrorMessage::ERROR_SEARCH_MAP_MESSAGE,
+                              req_obj)};
 }
 
 ResponseInfo Application::GetPlayersReqInfo(TargetRequestType req_type, const Header& header) const {
     return ExecuteAuthorized(header, [req_type, this](const string& token) {
-        if(auto player = players_->FindPlayerByToken(Token(token))) {
-            const auto session = player.value()->GetGameSession();
+        //Ответ строится по снимку сессии, поэтому не требует перехода в её strand
+        if(auto map_id = players_->FindPlayerMapId(Token(token))) {
+            const auto snapshot = game_->FindGameSessionById(*map_id)->GetSnapshot();
 
             switch (req_type) {
                 case TargetRequestType::GET_PLAYERS : {
-                    auto dogs = session.GetDogs();
-                    return ResponseInfo {http::status::ok,
-                                         MakeBodyJSON(dogs)};   
+                    const auto& body = snapshot->players_body.Get([&snapshot] {
+                        return MakeBodyJSON(snapshot->dogs);
+                    });
+                    //Тело принадлежит снимку, поэтому ответ продлевает время жизни снимка
+                    return ResponseInfo {http::status::ok, {}, etag::MakeVersionETag(**map_id, snapshot->version),
+                                         std::shared_ptr<const string>(snapshot, &body)};
                 }
 
                 case TargetRequestType::GET_STATE : {
-                    auto state = model::GameState{session.GetDogs(), session.GetLoot()};
-                    return ResponseInfo {http::status::ok,
-                                         MakeBodyJSON(state)};
+                    const auto& body = snapshot->state_body.Get([&snapshot] {
+                        return MakeBodyJSON(model::GameState{snapshot->dogs, snapshot->lost_objects});
+                    });
+                    return ResponseInfo {http::status::ok, {}, etag::MakeVersionETag(**map_id, snapshot->version),
+                                         std::shared_ptr<const string>(snapshot, &body)};
                 } 
             
                 default:
@@ -185,7 +231,10 @@ ResponseInfo Application::GetPlayersRecordList(PlayerRecordReqConfig&& config) {
                                               TargetErrorMessage::ERROR_BAD_REQUEST_MESSAGE)};
     }
 
-    std::vector<PlayerRecord> records = use_cases_->GetPlayersRecordList(config.start, config.max_items);
+    std::vector<PlayerRecord> records;
+    if(use_cases_) {
+        records = use_cases_->GetPlayersRecordList(config.start, config.max_items);
+    }
     
     return ResponseInfo{http::status::ok, MakeBodyJSON(records)};
 }
@@ -198,6 +247,14 @@ player::PlayersController::PlayersData Application::GetPlayersData() const {
     return players_->GetPlayersData();
 }
 
+player::PlayersController::PlayersData Application::GetPlayersData(const model::Map::Id& map_id) const {
+    return players_->GetPlayersData(map_id);
+}
+
+const model::Game::GameSessions& Application::GetSessions() const {
+    return game_->GetSessions();
+}
+
 std::chrono::milliseconds Application::GetRetirementTime() const {
     return game_->GetRetirementTime();
 }
@@ -225,6 +282,12 @@ optional<string> Application::FindHeader(const Header& header, string_view name_
 }
 
 void Application::SetRecords(const std::vector<player::PlayerRecord>& records) {
+    if(!use_cases_) {
+        return;
+    }
+
+    const auto start = metrics::Clock::now();
     use_cases_->AddPlayerRecord(records);
+    metrics::GetServerMetrics().ObserveDbWrite(metrics::Clock::now() - start);
 }
 } // namespace app
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <variant>
 #include <vector>
 
 #include "../../database/app/use_cases_impl.h"
@@ -18,7 +19,9 @@
 #include "../json/json_constructor.h"
 #include "../json/json_loader.h"
 #include "../model/static_object_prorerties.h"
+#include "../model/tick_phases.h"
 #include "../server/extra_data.h"
+#include "map_responses.h"
 #include "player_properties.h"
 
 namespace app {
@@ -26,6 +29,7 @@ const static size_t MAX_ITEMS = 100;
 
 namespace beast = boost::beast;
 namespace http = beast::http;
+namespace net = boost::asio;
 
 using Header = http::header<true, beast::http::fields>;
 
@@ -37,6 +41,10 @@ struct PlayerRecordReqConfig {
 struct ResponseInfo {
     http::status status;
     std::string body;  
+    //Заполняется для ответов, повторная отправка которых может быть заменена ответом 304
+    std::string etag = "";
+    //Готовое тело, которое отправляется вместо body без копирования
+    std::shared_ptr<const std::string> shared_body = nullptr;
 };
 
 struct ApplicationState {
@@ -52,6 +60,7 @@ public:
 
 class Application {
 public:
+    //Без базы данных рекорды игроков не сохраняются, а их список пуст
     Application() = default;
     explicit Application(postgres::DatabaseConfig&& config);
     
@@ -59,24 +68,44 @@ public:
     void JoinGame(const player::PlayersController::PlayersData& players);
 
     ResponseInfo UpdateState(const Header& header, const std::string& req_body);
-    ResponseInfo ProcessTickActions(const Header& header, const std::string& req_body);
-    void ProcessTickActions(const std::chrono::milliseconds& delta);
+    //Возвращает длительность тика из тела запроса, либо ответ с описанием ошибки
+    std::variant<std::chrono::milliseconds, ResponseInfo> ParseTickRequest(const Header& header, 
+                                                                           const std::string& req_body) const;
+    //Обрабатывает тик одной сессии и возвращает отправленных на пенсию игроков.
+    //Должна вызываться в strand этой сессии. phases заполняется при профилировании тика
+    std::vector<player::PlayerRecord> ProcessSessionTick(model::GameSession& session, 
+                                                         const std::chrono::milliseconds& delta,
+                                                         model::TickPhasesDuration* phases = nullptr);
+    //Публикует изменения, сделанные запросами игроков после последнего тика. Должна вызываться в strand сессии
+    void PublishSessionChanges(const model::Map::Id& map_id);
+    //Завершает тик после обработки всех сессий
+    void FinishTick(const std::vector<player::PlayerRecord>& records, const std::chrono::milliseconds& delta,
+                    model::TickPhasesDuration* phases = nullptr);
 
     const player::Player* FindPlayerByToken(const player::Token& token) const;
+    //Определяет карту игрока по заголовку запроса, не обращаясь к данным его сессии
+    std::optional<model::Map::Id> FindPlayerMapId(const Header& header) const;
+    //Ответ на запрос игрока, который не найден по токену
+    ResponseInfo MakeUnknownPlayerInfo(const Header& header) const;
 
+    //Сессии создаются сразу для всех карт, чтобы набор сессий не менялся во время работы сервера
     void SetGame(model::Game&& game);
     void SetListener(std::unique_ptr<ApplicationListener> listener);
 
-    ResponseInfo GetStaticObjectsInfo(targets_storage::TargetRequestType req_type, 
-                                      const std::string& req_obj,
-                                      const extra_data::LootTypes& types) const;
+    //Подготавливает ответы на запросы о картах; вызывается после SetGame
+    void PrepareMapResponses(const extra_data::LootTypes& types);
+
+    ResponseInfo GetStaticObjectsInfo(const std::string& req_obj) const;
     ResponseInfo GetPlayersReqInfo(targets_storage::TargetRequestType req_type, const Header& header) const;
     ResponseInfo GetPlayersRecordList(PlayerRecordReqConfig&& config);
     ApplicationState GetApplicationState() const;
     player::PlayersController::PlayersData GetPlayersData() const;
+    player::PlayersController::PlayersData GetPlayersData(const model::Map::Id& map_id) const;
+    const model::Game::GameSessions& GetSessions() const;
     std::chrono::milliseconds GetRetirementTime() const;
 private:
     std::unique_ptr<model::Game> game_ = nullptr;
+    MapResponses map_responses_;
     std::unique_ptr<player::PlayersController> players_ = std::make_unique<player::PlayersController>();
     std::unique_ptr<ApplicationListener> listener_ = nullptr;
 
@@ -10,6 +10,14 @@ ApplicationStateRepr::ApplicationStateRepr(const app::ApplicationState& app_stat
     }   
 }
 
+void ApplicationStateRepr::AddGameSession(const model::GameSession& session) {
+    game_sessions_.push_back(GameSessionRepr(session));
+}
+
+void ApplicationStateRepr::AddPlayersData(const PlayersData& players_data) {
+    players_data_.insert(players_data_.end(), players_data.begin(), players_data.end());
+}
+
 ApplicationStateRepr::PlayersData ApplicationStateRepr::RestorePlayersData() {
     return players_data_;
 }
@@ -26,6 +26,10 @@ public:
     ApplicationStateRepr() = default;
     explicit ApplicationStateRepr(const app::ApplicationState& app_state);
 
+    //Позволяют собирать состояние по одной сессии, не останавливая остальные
+    void AddGameSession(const model::GameSession& session);
+    void AddPlayersData(const PlayersData& players_data);
+
     [[nodiscard]] PlayersData RestorePlayersData();
 
     [[nodiscard]] GameSessionsRepr RestoreGameSessionsRepr();
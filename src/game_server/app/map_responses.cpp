@@ -0,0 +1,38 @@
+#include "../json/json_constructor.h"
+#include "../server/etag.h"
+#include "map_responses.h"
+
+namespace app {
+namespace {
+PreparedBody PrepareBody(std::string&& body) {
+    std::string tag = etag::ComputeETag(body);
+    return {std::make_shared<const std::string>(std::move(body)), std::move(tag)};
+}
+}// namespace
+
+//_________MapResponses_________
+MapResponses::MapResponses(const model::Game& game, const extra_data::LootTypes& types)
+    : maps_info_(PrepareBody(json_constructor::MakeBodyJSON(targets_storage::TargetRequestType::GET_MAPS_INFO, game))) {
+    const boost::json::array no_types;
+
+    for(const auto& map : game.GetMaps()) {
+        const auto* map_types = types.GetTypes(map.GetId());
+        maps_.emplace(map.GetId(), PrepareBody(json_constructor::MakeBodyJSON(targets_storage::TargetRequestType::GET_MAP_BY_ID, 
+                                                                              game, 
+                                                                              *map.GetId(), 
+                                                                              map_types ? map_types : &no_types)));
+    }
+}
+
+const PreparedBody& MapResponses::GetMapsInfo() const noexcept {
+    return maps_info_;
+}
+
+const PreparedBody* MapResponses::FindMap(const model::Map::Id& id) const {
+    if(auto it = maps_.find(id); it != maps_.end()) {
+        return &it->second;
+    }
+
+    return nullptr;
+}
+}//namespace app
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "../model/game_properties.h"
+#include "../model/static_object_prorerties.h"
+#include "../server/extra_data.h"
+#include "../tagged.h"
+
+namespace app {
+//Тело ответа, подготовленное заранее и разделяемое всеми запросами
+struct PreparedBody {
+    std::shared_ptr<const std::string> body;
+    std::string etag;
+};
+
+//Карты и типы трофеев не изменяются после загрузки, поэтому ответы на запросы о них строятся один раз
+class MapResponses {
+public:
+    MapResponses() = default;
+    MapResponses(const model::Game& game, const extra_data::LootTypes& types);
+
+    const PreparedBody& GetMapsInfo() const noexcept;
+    //Возвращает nullptr, если карта не найдена
+    const PreparedBody* FindMap(const model::Map::Id& id) const;
+private:
+    using MapIdHasher = util::TaggedHasher<model::Map::Id>;
+    using MapIdToBody = std::unordered_map<model::Map::Id, PreparedBody, MapIdHasher>;
+
+    PreparedBody maps_info_;
+    MapIdToBody maps_;
+};
+}//namespace app
\ No newline at end of file
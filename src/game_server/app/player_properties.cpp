@@ -24,29 +24,31 @@ void Player::UpdateStateDog(Direction dir) const {
 
     switch (dir) {
         case Direction::U :
-            dog_->UpdateState({DEF_SPEED, -speed_on_map}, dir);       
+            dog_.UpdateState({DEF_SPEED, -speed_on_map}, dir);       
             break;
 
         case Direction::D :
-            dog_->UpdateState({DEF_SPEED, speed_on_map}, dir); 
+            dog_.UpdateState({DEF_SPEED, speed_on_map}, dir); 
             break;
 
         case Direction::L :
-            dog_->UpdateState({-speed_on_map, DEF_SPEED}, dir); 
+            dog_.UpdateState({-speed_on_map, DEF_SPEED}, dir); 
             break;
 
         case Direction::R :
-            dog_->UpdateState({speed_on_map, DEF_SPEED}, dir);
+            dog_.UpdateState({speed_on_map, DEF_SPEED}, dir);
             break;
 
         default:
-            dog_->UpdateState({DEF_SPEED, DEF_SPEED}, dog_->GetDirection());
+            dog_.UpdateState({DEF_SPEED, DEF_SPEED}, dog_.GetDirection());
             break;
     }
 
-    if(dog_->GetDirection() != Direction::STOP) {
-        dog_->SetInactiveTime(std::chrono::milliseconds(0));
+    if(dog_.GetDirection() != Direction::STOP) {
+        dog_.SetInactiveTime(std::chrono::milliseconds(0));
     }
+
+    session_->MarkChanged();
 }
 
 void Player::RetireDog(size_t dog_id) {
@@ -58,8 +60,8 @@ const GameSession& Player::GetGameSession() const {
     return *session_;
 }
 
-const Dog* Player::GetDog() const {
-    return dog_.get();
+const DogHandle& Player::GetDog() const {
+    return dog_;
 }
 
 Map::Id Player::GetMapId() const {
@@ -67,7 +69,7 @@ Map::Id Player::GetMapId() const {
 }
 
 size_t Player::GetDogId() const {
-    return dog_->GetId();
+    return dog_.GetId();
 }
 
 bool Player::IsRetirement() const {
@@ -76,16 +78,22 @@ bool Player::IsRetirement() const {
 
 //__________PlayersController__________
 AuthorizationInfo PlayersController::AddPlayer(const UnitParameters& parameters) {
+    std::unique_lock lock(mutex_);
     Token token(GenerateToken());
 
     Player player(parameters);
-    token_to_players_.insert({token, player});
+    if(token_to_players_.insert({token, player}).second) {
+        session_to_tokens_[parameters.session.get()].push_back(token);
+    }
 
     return AuthorizationInfo{token, player.GetDogId()};
 }
 
 void PlayersController::AddPlayer(Token token, const UnitParameters& parameters) {
-    token_to_players_.insert({token, Player(parameters)});
+    std::unique_lock lock(mutex_);
+    if(token_to_players_.insert({token, Player(parameters)}).second) {
+        session_to_tokens_[parameters.session.get()].push_back(std::move(token));
+    }
 }
 
 std::optional<string> PlayersController::ValidateToken(const string& value_token) const {
@@ -105,26 +113,51 @@ std::optional<string> PlayersController::ValidateToken(const string& value_token
     return std::nullopt;
 }
 
-std::vector<PlayerRecord> PlayersController::SendIntoRetirement(const std::chrono::milliseconds& retirement_time) {
+std::vector<PlayerRecord> PlayersController::SendIntoRetirement(const GameSession& session,
+                                                                const std::chrono::milliseconds& retirement_time) {
     std::vector<PlayerRecord> retirement_palyers;
+    std::vector<Token> retired_tokens;
+
+    {
+        //Игроков сессии меняет только её strand, поэтому для их просмотра достаточно
+        //разделяемой блокировки, и параллельно обрабатываемые сессии не ждут друг друга
+        std::shared_lock lock(mutex_);
+        auto session_tokens = session_to_tokens_.find(&session);
+        if(session_tokens == session_to_tokens_.end()) {
+            return retirement_palyers;
+        }
 
-    for(auto& [_, player] : token_to_players_) {
-        auto dog = player.GetDog();
-        if(dog->GetInactiveTime() >= retirement_time) {
-            retirement_palyers.push_back({dog->GetName(), dog->GetTimeInGame(), dog->GetScore()});
-            player.RetireDog(dog->GetId());
+        for(const auto& token : session_tokens->second) {
+            auto& player = token_to_players_.at(token);
+            const auto& dog = player.GetDog();
+
+            if(dog.GetInactiveTime() >= retirement_time) {
+                retirement_palyers.push_back({dog.GetName(), dog.GetTimeInGame(), dog.GetScore()});
+                player.RetireDog(dog.GetId());
+                retired_tokens.push_back(token);
+            }
         }
     }
 
-    //Безопасно удаляем игроков-пенсионеров
-    std::erase_if(token_to_players_, [](const auto& item) {
-        return item.second.IsRetirement();
+    if(retired_tokens.empty()) {
+        return retirement_palyers;
+    }
+
+    //Исключительная блокировка нужна только для удаления игроков-пенсионеров
+    std::unique_lock lock(mutex_);
+    for(const auto& token : retired_tokens) {
+        token_to_players_.erase(token);
+    }
+
+    std::erase_if(session_to_tokens_.at(&session), [this](const Token& token) {
+        return !token_to_players_.contains(token);
     });
 
     return retirement_palyers;
 }
 
 std::optional<const Player*> PlayersController::FindPlayerByToken(const Token& token) const {
+    std::shared_lock lock(mutex_);
     auto iter = token_to_players_.find(token);
 
     if(iter == token_to_players_.end()) {
@@ -134,8 +167,20 @@ std::optional<const Player*> PlayersController::FindPlayerByToken(const Token& t
     return &iter->second;
 }
 
+std::optional<Map::Id> PlayersController::FindPlayerMapId(const Token& token) const {
+    std::shared_lock lock(mutex_);
+    auto iter = token_to_players_.find(token);
+
+    if(iter == token_to_players_.end()) {
+        return std::nullopt;
+    }
+
+    return iter->second.GetMapId();
+}
+
 std::vector<PlayerData> PlayersController::GetPlayersData() const {
     std::vector<PlayerData> result;
+    std::shared_lock lock(mutex_);
 
     for(const auto& [token, player] : token_to_players_) {
         result.push_back(PlayerData{*player.GetMapId(), *token, player.GetDogId()});
@@ -144,6 +189,19 @@ std::vector<PlayerData> PlayersController::GetPlayersData() const {
     return result;
 }
 
+std::vector<PlayerData> PlayersController::GetPlayersData(const Map::Id& map_id) const {
+    std::vector<PlayerData> result;
+    std::shared_lock lock(mutex_);
+
+    for(const auto& [token, player] : token_to_players_) {
+        if(player.GetMapId() == map_id) {
+            result.push_back(PlayerData{*map_id, *token, player.GetDogId()});
+        }
+    }
+
+    return result;
+}
+
 string PlayersController::GenerateToken() {
     std::stringstream buf;
 
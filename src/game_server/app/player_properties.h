@@ -2,8 +2,10 @@
 
 #include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <random>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -54,14 +56,14 @@ public:
     void RetireDog (size_t dog_id);
 
     const model::GameSession& GetGameSession() const;
-    const model::Dog* GetDog() const;
+    const model::DogHandle& GetDog() const;
     model::Map::Id GetMapId() const;
     size_t GetDogId() const;
 
     bool IsRetirement() const;
 private:
     std::shared_ptr<model::GameSession> session_;
-    mutable std::shared_ptr<model::Dog> dog_;
+    mutable model::DogHandle dog_;
     bool is_retirement_ = false;
 };
 
@@ -72,6 +74,10 @@ public:
     virtual std::vector<PlayerRecord> GetPlayersRecordList(size_t offset, size_t limit) const = 0;
 };
 
+//Таблица игроков общая для всех сессий и защищена мьютексом. Данные самого игрока
+//изменяются только в strand его игровой сессии, поэтому указатель, полученный
+//из FindPlayerByToken, можно использовать только внутри этого strand.
+//Игроки сессии добавляются и удаляются тоже только в её strand
 class PlayersController {
 public:
     using PlayersData = std::vector<player::PlayerData>;
@@ -80,13 +86,21 @@ public:
     void AddPlayer(Token token, const model::UnitParameters& parameters);
 
     std::optional<std::string> ValidateToken(const std::string& value_token) const;
-    std::vector<PlayerRecord> SendIntoRetirement(const std::chrono::milliseconds& retirement_time);
+    //Отправляет на пенсию неактивных игроков одной сессии
+    std::vector<PlayerRecord> SendIntoRetirement(const model::GameSession& session, 
+                                                 const std::chrono::milliseconds& retirement_time);
 
     std::optional<const Player*> FindPlayerByToken(const Token& token) const;
+    //Безопасен для вызова из любого потока
+    std::optional<model::Map::Id> FindPlayerMapId(const Token& token) const;
 
     PlayersData GetPlayersData() const;
+    PlayersData GetPlayersData(const model::Map::Id& map_id) const;
 private:
     std::unordered_map<Token, Player, util::TaggedHasher<Token>> token_to_players_;
+    //Токены игроков каждой сессии, чтобы тик сессии не просматривал игроков других карт
+    std::unordered_map<const model::GameSession*, std::vector<Token>> session_to_tokens_;
+    mutable std::shared_mutex mutex_;
 
     std::random_device random_device_;
     std::mt19937_64 generator1_{[this] {
@@ -1,3 +1,11 @@
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+
+#include <atomic>
+#include <utility>
+#include <variant>
+
+#include "../server/etag.h"
 #include "../server/logger.h"
 #include "api_handler.h"
 
@@ -14,34 +22,6 @@ using std::string_view;
 
 namespace http_handler {
 const static string_view NO_CACHE = "no-cache";
-const static string_view RESPONSE_SENT = "response sent";
-
-//_________Ticker_________
-Ticker::Ticker(Strand& strand, const std::chrono::milliseconds& period, Handler handler)
-    : strand_(strand)
-    , period_(period)
-    , handler_(handler) {
-}
-
-void Ticker::Start() {
-    last_tick_ = std::chrono::steady_clock::now();
-    ScheduleTick();
-}
-
-void Ticker::ScheduleTick() {
-    timer_.expires_after(std::chrono::duration_cast<std::chrono::milliseconds>(period_));
-    timer_.async_wait(
-        net::bind_executor(strand_, [self = shared_from_this()](sys::error_code ec) {
-            self->OnTick(ec);
-    }));
-}
-
-void Ticker::OnTick(sys::error_code ec) {
-    auto current_tick = std::chrono::steady_clock::now();
-    handler_(std::chrono::duration_cast<std::chrono::milliseconds>(current_tick - last_tick_));
-    last_tick_ = current_tick;
-    ScheduleTick();
-}
 
 //_________BuilderApiHandler_________
 BuilderApiHandler& BuilderApiHandler::SetStrand(Strand&& strand) {
@@ -74,54 +54,145 @@ BuilderApiHandler& BuilderApiHandler::SetDatabaseConfig(postgres::DatabaseConfig
     return *this;
 }
 
+BuilderApiHandler& BuilderApiHandler::SetTickThreads(unsigned threads_count) {
+    tick_threads_ = threads_count;
+    return *this;
+}
+
+BuilderApiHandler& BuilderApiHandler::SetTickProfiling(bool enabled) {
+    profile_ticks_ = enabled;
+    return *this;
+}
+
+BuilderApiHandler& BuilderApiHandler::SetTickPolicy(TickPolicy policy, unsigned max_catch_up_steps) {
+    tick_policy_ = policy;
+    max_catch_up_steps_ = max_catch_up_steps;
+    return *this;
+}
+
 http_handler::ApiHandler BuilderApiHandler::Build() {
     return ApiHandler(std::move(*api_strand_.release()),
-                      std::move(*config_.release()),
+                      config_ ? std::make_optional(std::move(*config_)) : std::nullopt,
                       std::move(*loot_types_.release()),
                       std::move(*timer_.release()),
                       std::move(*state_file_.release()),
-                      std::move(*game_.release()));
+                      std::move(*game_.release()),
+                      tick_threads_,
+                      profile_ticks_,
+                      tick_policy_,
+                      max_catch_up_steps_);
 }
 
 //_________ApiHandler_________
 ApiHandler::ApiHandler(Strand&& api_strand,
-                       postgres::DatabaseConfig&& config, 
+                       std::optional<postgres::DatabaseConfig>&& config, 
                        extra_data::LootTypes&& loot_types, 
                        std::chrono::milliseconds&& timer, 
                        std::filesystem::path&& state_file,
-                       model::Game&& game)  
+                       model::Game&& game,
+                       unsigned tick_threads,
+                       bool profile_ticks,
+                       TickPolicy tick_policy,
+                       unsigned max_catch_up_steps)  
     : api_strand_(std::forward<Strand>(api_strand))
-    , app_(std::move(config))
-    , loot_types_(std::forward<extra_data::LootTypes>(loot_types))
+    , app_(config ? app::Application(std::move(*config)) : app::Application())
     , state_handler_(std::move(state_file))
     , timer_(std::forward<std::chrono::milliseconds>(timer))
+    , tick_policy_(tick_policy)
+    , max_catch_up_steps_(max_catch_up_steps)
     , success_restore_(state_handler_.TryRestoreState(std::move(game), app_)) {
+    app_.PrepareMapResponses(loot_types);
+
+    if(profile_ticks) {
+        tick_profiler_ = std::make_unique<tick_profiler::TickProfiler>(timer_);
+    }
+
+    //При количестве потоков больше одного сессии обрабатываются в отдельном пуле, не занимая потоки ввода-вывода
+    if(tick_threads > 1) {
+        tick_pool_ = std::make_unique<net::thread_pool>(tick_threads);
+    }
+
+    for(const auto& session : app_.GetSessions()) {
+        auto executor = tick_pool_ ? net::any_io_executor(tick_pool_->get_executor())
+                                   : net::any_io_executor(api_strand_.get_inner_executor());
+        session_strands_.emplace(session->GetMapId(), net::make_strand(executor));
+        session_metrics_.emplace(session->GetMapId(), &metrics::GetServerMetrics().AddSession(*session->GetMapId()));
+        session_publishing_.emplace(session->GetMapId(), SessionPublishing{});
+    }
 }
 
 void ApiHandler::Start(std::chrono::milliseconds&& save_period) {  
     if(success_restore_ && save_period.count() != 0) {
-        app_.SetListener(std::make_unique<SerializingListener>(std::move(save_period), 
-                                                                         app_, 
-                                                                         [&](app::ApplicationState state) {
-                                                                                 state_handler_.SaveState(state);
-                                                                        })
+        app_.SetListener(std::make_unique<SerializingListener>(std::move(save_period), [this] {
+                             SaveStateBySessions(0, std::make_shared<serialization::ApplicationStateRepr>());
+                         })
                         );
     }
 
     if(timer_.count() != 0) {
         ticker_ = std::make_shared<Ticker>(api_strand_, 
-                                           timer_, [&](std::chrono::milliseconds delta) {
-                                           app_.ProcessTickActions(delta);
-                                           });
+                                           timer_, [this](std::chrono::milliseconds delta, std::function<void()> on_complete) {
+                                           ProcessTick(delta, std::move(on_complete));
+                                           },
+                                           tick_policy_, max_catch_up_steps_);
+        ticker_->SetOverrunObserver([](std::uint64_t overruns) {
+            metrics::GetServerMetrics().AddTickOverruns(overruns);
+        });
         ticker_->Start(); 
     }
 }
 
-StringResponse ApiHandler::HanldeApiRequest(const StringRequest& req, TargetRequestType req_type) {
-    auto start = std::chrono::high_resolution_clock::now();
+void ApiHandler::DispatchApiRequest(StringRequest&& req, TargetRequestType req_type, ResponseSender&& send) {
+    auto request = std::make_shared<const StringRequest>(std::move(req));
+    auto handle = [this, request, req_type, send] {
+        send(HanldeApiRequest(*request, req_type));
+    };
 
-    http::status status;
-    StringResponse response;
+    switch (req_type) {
+        //Карты не изменяются после загрузки, а состояние сессий читается из опубликованных снимков,
+        //поэтому такие запросы обрабатываются в текущем потоке
+        case TargetRequestType::GET_MAPS_INFO :
+        case TargetRequestType::GET_MAP_BY_ID :
+        case TargetRequestType::GET_PLAYERS   :
+        case TargetRequestType::GET_STATE     :
+            handle();
+            break;
+
+        case TargetRequestType::POST_ACTION : {
+            if(auto map_id = app_.FindPlayerMapId(request->base())) {
+                DispatchToSession(*map_id, request, req_type, send);
+            } else {
+                auto start = std::chrono::high_resolution_clock::now();
+                send(MakeApiResponse(*request, app_.MakeUnknownPlayerInfo(request->base()), start));
+            }
+            break;
+        }
+
+        case TargetRequestType::POST_JOIN_GAME : {
+            //Запрос с некорректной картой отклоняется без обращения к сессиям
+            auto joining_info = json_loader::LoadJoiningInfo(request->body());
+            if(joining_info && session_strands_.contains(joining_info->map_id)) {
+                DispatchToSession(joining_info->map_id, request, req_type, send);
+            } else {
+                handle();
+            }
+            break;
+        }
+
+        case TargetRequestType::POST_TICK :
+            net::dispatch(api_strand_, [this, request, send]() mutable {
+                HandleTickRequest(request, std::move(send));
+            });
+            break;
+
+        default :
+            net::dispatch(api_strand_, std::move(handle));
+            break;
+    }
+}
+
+ApiResponse ApiHandler::HanldeApiRequest(const StringRequest& req, TargetRequestType req_type) {
+    auto start = std::chrono::high_resolution_clock::now();
 
     std::unique_ptr<app::ResponseInfo> resp_info = nullptr;
 
@@ -129,7 +200,7 @@ StringResponse ApiHandler::HanldeApiRequest(const StringRequest& req, TargetRequ
         case TargetRequestType::GET_MAPS_INFO :
         case TargetRequestType::GET_MAP_BY_ID : {
             string req_obj = ComputeRequestedObject(req.target());
-            resp_info = std::make_unique<ResponseInfo>(app_.GetStaticObjectsInfo(req_type, req_obj, loot_types_));
+            resp_info = std::make_unique<ResponseInfo>(app_.GetStaticObjectsInfo(req_obj));
             break;
         }
 
@@ -156,6 +227,17 @@ StringResponse ApiHandler::HanldeApiRequest(const StringRequest& req, TargetRequ
             resp_info = std::make_unique<ResponseInfo>(app_.GetPlayersRecordList(std::move(config)));
             break;
         }
+
+        case TargetRequestType::GET_TICK_PROFILE : {
+            if(tick_profiler_) {
+                resp_info = std::make_unique<ResponseInfo>(ResponseInfo{http::status::ok, MakeBodyJSON(*tick_profiler_)});
+            } else {
+                resp_info = std::make_unique<ResponseInfo>(ResponseInfo{http::status::not_found,
+                                                                        MakeBodyErrorJSON(TargetErrorCode::ERROR_BAD_REQUEST_CODE,
+                                                                                          TargetErrorMessage::ERROR_PROFILING_DISABLED_MESSAGE)});
+            }
+            break;
+        }
             
         case TargetRequestType::POST_JOIN_GAME : 
             resp_info = std::make_unique<ResponseInfo>(app_.JoinGame(req.body()));
@@ -165,40 +247,24 @@ StringResponse ApiHandler::HanldeApiRequest(const StringRequest& req, TargetRequ
             resp_info = std::make_unique<ResponseInfo>(app_.UpdateState(req.base(), req.body()));
             break;
         
-        case TargetRequestType::POST_TICK : {
-            if(ticker_.get() == nullptr) {
-                resp_info = std::make_unique<ResponseInfo>(app_.ProcessTickActions(req.base(), req.body()));
-                break;
-            }
-        }
-
+        //Тик обрабатывается асинхронно в HandleTickRequest
         default : {
-            status = http::status::bad_request;
-            response.body() = MakeBodyErrorJSON(TargetErrorCode::ERROR_BAD_REQUEST_CODE,
-                                                TargetErrorMessage::ERROR_BAD_REQUEST_MESSAGE);
+            resp_info = std::make_unique<ResponseInfo>(ResponseInfo{http::status::bad_request,
+                                                                    MakeBodyErrorJSON(TargetErrorCode::ERROR_BAD_REQUEST_CODE,
+                                                                                      TargetErrorMessage::ERROR_BAD_REQUEST_MESSAGE)});
             break;
         }
     }
 
-    if(resp_info) {
-        status = resp_info->status;
-        response.body() = resp_info->body;
-    }
-    response.insert(http::field::cache_control, NO_CACHE);
-    response.result(status);
-    response.version(req.version());
-    response.keep_alive(req.keep_alive());
-    response.insert(http::field::content_type, ContentType::APPLICATION_JSON);
-    response.content_length(response.body().size());
-
-    auto duration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
-    logger::LogExecution(MakeLogResponceJSON(duration, static_cast<unsigned>(status), 
-                                             ContentType::APPLICATION_JSON), RESPONSE_SENT);
-
-    return response;
+    return MakeApiResponse(req, std::move(*resp_info), start);
 }
 
 void ApiHandler::SaveState() const {
+    //Дожидаемся задач, оставшихся в strand игровых сессий
+    if(tick_pool_) {
+        tick_pool_->join();
+    }
+
     state_handler_.SaveState(app_.GetApplicationState());
 }
 
@@ -206,10 +272,194 @@ Strand ApiHandler::GetApiStrand() const {
     return api_strand_;
 }
 
+SessionStrand& ApiHandler::GetSessionStrand(const model::Map::Id& map_id) {
+    return session_strands_.at(map_id);
+}
+
+void ApiHandler::DispatchToSession(const model::Map::Id& map_id, std::shared_ptr<const StringRequest> request,
+                                   TargetRequestType req_type, ResponseSender send) {
+    auto& strand = GetSessionStrand(map_id);
+
+    net::dispatch(strand, [this, &strand, map_id, request, req_type, send = std::move(send)] {
+        auto response = std::make_shared<ApiResponse>(HanldeApiRequest(*request, req_type));
+        auto& publishing = session_publishing_.at(map_id);
+
+        //Клиент, получивший ответ, должен сразу видеть свои изменения в состоянии сессии
+        publishing.pending_sends.push_back([send, response] {
+            send(std::move(*response));
+        });
+
+        //Публикация ставится в конец очереди strand, поэтому запросы, уже ожидающие в ней, попадут в тот же снимок
+        if(!std::exchange(publishing.scheduled, true)) {
+            net::post(strand, [this, map_id] {
+                auto& publishing = session_publishing_.at(map_id);
+                publishing.scheduled = false;
+                app_.PublishSessionChanges(map_id);
+
+                for(const auto& pending_send : std::exchange(publishing.pending_sends, {})) {
+                    pending_send();
+                }
+            });
+        }
+    });
+}
+
 string ApiHandler::ComputeRequestedObject(string_view target) const {
     size_t pos = UsingTargetPath::MAPS.size(); 
     char delim = '/';
     return pos == target.size() ? ""s
                                 : string(target.substr(target.find_first_of(delim, pos) + 1));
 }
+
+void ApiHandler::HandleTickRequest(std::shared_ptr<const StringRequest> req, ResponseSender&& send) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Ручное управление временем доступно только без автоматического тика
+    if(ticker_) {
+        send(MakeApiResponse(*req, {http::status::bad_request,
+                                    MakeBodyErrorJSON(TargetErrorCode::ERROR_BAD_REQUEST_CODE,
+                                                      TargetErrorMessage::ERROR_BAD_REQUEST_MESSAGE)}, start));
+        return;
+    }
+
+    auto tick = app_.ParseTickRequest(req->base(), req->body());
+    if(auto resp_info = std::get_if<ResponseInfo>(&tick)) {
+        send(MakeApiResponse(*req, std::move(*resp_info), start));
+        return;
+    }
+
+    //Ответ отправляется только после того, как тик обработан всеми сессиями
+    ProcessTick(std::get<std::chrono::milliseconds>(tick), [this, req, send = std::move(send), start] {
+        send(MakeApiResponse(*req, {http::status::ok, MakeBodyEmptyObject()}, start));
+    });
+}
+
+void ApiHandler::ProcessTick(std::chrono::milliseconds delta, std::function<void()> on_complete) {
+    //Каждая сессия записывает отправленных на пенсию игроков в свою ячейку,
+    //последняя из них передаёт завершение тика в api_strand_
+    struct TickResult {
+        explicit TickResult(size_t sessions_count) 
+            : records(sessions_count)
+            , pending(sessions_count) {
+        }
+
+        std::vector<std::vector<player::PlayerRecord>> records;
+        std::vector<tick_profiler::PhasesDuration> phases;
+        std::atomic<size_t> pending;
+    };
+
+    const auto start = tick_profiler::Clock::now();
+    const auto& sessions = app_.GetSessions();
+    auto result = std::make_shared<TickResult>(sessions.size());
+
+    if(tick_profiler_) {
+        result->phases.resize(sessions.size());
+    }
+
+    auto finish = [this, delta, start, result, on_complete] {
+        std::vector<player::PlayerRecord> records;
+        for(const auto& session_records : result->records) {
+            records.insert(records.end(), session_records.begin(), session_records.end());
+        }
+
+        tick_profiler::PhasesDuration phases{};
+        for(const auto& session_phases : result->phases) {
+            for(size_t i = 0; i < phases.size(); ++i) {
+                phases[i] += session_phases[i];
+            }
+        }
+
+        app_.FinishTick(records, delta, tick_profiler_ ? &phases : nullptr);
+        if(tick_profiler_) {
+            RecordTickProfile(delta, tick_profiler::Clock::now() - start, phases);
+        }
+
+        if(on_complete) {
+            on_complete();
+        }
+    };
+
+    if(sessions.empty()) {
+        finish();
+        return;
+    }
+
+    for(size_t i = 0; i < sessions.size(); ++i) {
+        auto session = sessions[i];
+        auto* session_metrics = session_metrics_.at(session->GetMapId());
+
+        net::post(GetSessionStrand(session->GetMapId()), [this, session, session_metrics, i, delta, result, finish] {
+            const auto start = metrics::Clock::now();
+            auto* phases = result->phases.empty() ? nullptr : &result->phases[i];
+            result->records[i] = app_.ProcessSessionTick(*session, delta, phases);
+
+            session_metrics->tick_duration.ObserveDuration(metrics::Clock::now() - start);
+            session_metrics->gather_events.Observe(static_cast<double>(session->GetGatherEventsCount()));
+            session_metrics->dogs.Set(static_cast<double>(session->GetDogs().size()));
+            session_metrics->loot.Set(static_cast<double>(session->GetLoot().size()));
+
+            if(result->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                net::dispatch(api_strand_, finish);
+            }
+        });
+    }
+}
+
+void ApiHandler::RecordTickProfile(std::chrono::milliseconds delta, tick_profiler::Clock::duration duration,
+                                   const tick_profiler::PhasesDuration& phases) {
+    const auto& record = tick_profiler_->AddTick(delta, duration, phases);
+    metrics::GetServerMetrics().ObserveTickPhases(phases);
+
+    if(record.overrun) {
+        logger::LogExecution(MakeLogTickOverrunJSON(record, tick_profiler_->GetPeriod()), "tick overrun"sv);
+    }
+}
+
+void ApiHandler::SaveStateBySessions(size_t session_index, std::shared_ptr<serialization::ApplicationStateRepr> repr) {
+    const auto& sessions = app_.GetSessions();
+
+    if(session_index == sessions.size()) {
+        net::dispatch(api_strand_, [this, repr] {
+            state_handler_.SaveState(*repr);
+        });
+        return;
+    }
+
+    //Следующая сессия сохраняется только после предыдущей, поэтому repr не нуждается в синхронизации
+    auto session = sessions[session_index];
+    net::post(GetSessionStrand(session->GetMapId()), [this, session, session_index, repr] {
+        repr->AddGameSession(*session);
+        repr->AddPlayersData(app_.GetPlayersData(session->GetMapId()));
+        SaveStateBySessions(session_index + 1, repr);
+    });
+}
+
+ApiResponse ApiHandler::MakeApiResponse(const StringRequest& req, ResponseInfo resp_info, TimePoint start) const {
+    ApiResponse response;
+    http::status status = resp_info.status;
+
+    //Клиент уже получил эту версию ответа, поэтому тело не отправляется
+    if(!resp_info.etag.empty() && etag::MatchesIfNoneMatch(req[http::field::if_none_match], resp_info.etag)) {
+        status = http::status::not_modified;
+    } else {
+        //Тело, построенное для этого запроса, перемещается, а готовое разделяется без копирования
+        response.body() = resp_info.shared_body ? std::move(resp_info.shared_body)
+                                                : std::make_shared<const string>(std::move(resp_info.body));
+        response.insert(http::field::content_type, ContentType::APPLICATION_JSON);
+        response.content_length(response.body()->size());
+    }
+
+    response.insert(http::field::cache_control, NO_CACHE);
+    response.result(status);
+    response.version(req.version());
+    response.keep_alive(req.keep_alive());
+    if(!resp_info.etag.empty()) {
+        response.insert(http::field::etag, resp_info.etag);
+    }
+
+    auto duration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    logger::LogResponse(duration, static_cast<int>(status), ContentType::APPLICATION_JSON);
+
+    return response;
+}
 }
\ No newline at end of file
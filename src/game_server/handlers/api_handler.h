@@ -5,23 +5,32 @@
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/strand.hpp>
-#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/url/url_view.hpp>
 
 #include <chrono>
 #include <filesystem>
+#include <functional>
 #include <string>
 #include <string_view>
 #include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 #include "../../database/postgres/postgres.h"
 #include "../app/application.h"
+#include "../app/detail/app_serializer.h"
 #include "../server/extra_data.h"
+#include "../server/file_cache.h"
+#include "../server/metrics.h"
+#include "../server/tick_profiler.h"
 #include "../model/game_properties.h"
 #include "../model/static_object_prorerties.h"
 #include "state_handler.h"
 #include "target_storage.h"
+#include "ticker.h"
 
 namespace beast = boost::beast;
 namespace fs    = std::filesystem;
@@ -33,29 +42,14 @@ namespace sys   = boost::system;
 using StringRequest = http::request<http::string_body>;
 // Ответ, тело которого представлено в виде строки
 using StringResponse = http::response<http::string_body>;
+// Ответ API, тело которого ссылается на готовую строку и не копируется
+using ApiResponse = http::response<file_cache::SharedBufferBody>;
 
 using Strand = net::strand<net::io_context::executor_type>;
+//Strand игровой сессии может работать как в io_context, так и в отдельном пуле потоков
+using SessionStrand = net::strand<net::any_io_executor>;
 
 namespace http_handler {
-class Ticker : public std::enable_shared_from_this<Ticker> {
-public:
-    using Handler = std::function<void(std::chrono::milliseconds)>;
-
-    Ticker(Strand& strand, const std::chrono::milliseconds& period, Handler handler);
-
-    void Start();
-private:
-    void ScheduleTick();
-    void OnTick(sys::error_code ec);
-
-private:
-    Strand& strand_;
-    net::steady_timer timer_{strand_};
-    std::chrono::milliseconds period_;
-    Handler handler_;
-    std::chrono::time_point<std::chrono::steady_clock> last_tick_;
-};
-
 class ApiHandler;
 
 class BuilderApiHandler {
@@ -65,7 +59,11 @@ public:
     BuilderApiHandler& SetLootTypes(extra_data::LootTypes&& loot_types);
     BuilderApiHandler& SetTimer(std::chrono::milliseconds&& timer);
     BuilderApiHandler& SetStateFile(fs::path path);
+    //Без конфигурации сервер работает без базы данных рекордов
     BuilderApiHandler& SetDatabaseConfig(postgres::DatabaseConfig&& config);
+    BuilderApiHandler& SetTickThreads(unsigned threads_count);
+    BuilderApiHandler& SetTickProfiling(bool enabled);
+    BuilderApiHandler& SetTickPolicy(TickPolicy policy, unsigned max_catch_up_steps = DEFAULT_MAX_CATCH_UP_STEPS);
 
     ApiHandler Build();
 private:
@@ -75,32 +73,81 @@ private:
     std::unique_ptr<std::chrono::milliseconds> timer_ = nullptr;
     std::unique_ptr<fs::path> state_file_ = nullptr;
     std::unique_ptr<postgres::DatabaseConfig> config_ = nullptr;
+    unsigned tick_threads_ = 0;
+    bool profile_ticks_ = false;
+    TickPolicy tick_policy_ = TickPolicy::VARIABLE;
+    unsigned max_catch_up_steps_ = DEFAULT_MAX_CATCH_UP_STEPS;
 };
 
+//Данные каждой игровой сессии изменяются только в её собственном strand, поэтому запросы
+//игроков разных карт не ждут друг друга. Данные карт и снимки сессий читаются без перехода в strand,
+//а рекорды, тик и сохранение состояния координируются в api_strand_
 class ApiHandler {
 public:
+    using ResponseSender = std::function<void(ApiResponse&&)>;
+
     friend BuilderApiHandler;
     void Start(std::chrono::milliseconds&& save_period);
-    StringResponse HanldeApiRequest(const StringRequest& req, targets_storage::TargetRequestType req_type);
+    //Выполняет запрос в strand, которому принадлежат нужные ему данные, и передаёт ответ в send
+    void DispatchApiRequest(StringRequest&& req, targets_storage::TargetRequestType req_type, ResponseSender&& send);
+    ApiResponse HanldeApiRequest(const StringRequest& req, targets_storage::TargetRequestType req_type);
     void SaveState() const;
 
     Strand GetApiStrand() const;
+    SessionStrand& GetSessionStrand(const model::Map::Id& map_id);
 private:
+    using MapIdHasher = util::TaggedHasher<model::Map::Id>;
+    using SessionStrands = std::unordered_map<model::Map::Id, SessionStrand, MapIdHasher>;
+    using SessionsMetrics = std::unordered_map<model::Map::Id, metrics::SessionMetrics*, MapIdHasher>;
+    //Публикация снимка, поставленная в strand сессии, и ответы, ожидающие её
+    struct SessionPublishing {
+        bool scheduled = false;
+        std::vector<std::function<void()>> pending_sends;
+    };
+    using SessionsPublishing = std::unordered_map<model::Map::Id, SessionPublishing, MapIdHasher>;
+    using TimePoint = std::chrono::high_resolution_clock::time_point;
+
     ApiHandler(Strand&& api_strand, 
-               postgres::DatabaseConfig&& config,
+               std::optional<postgres::DatabaseConfig>&& config,
                extra_data::LootTypes&& loot_types, 
                std::chrono::milliseconds&& timer,
                std::filesystem::path&& state_file,
-               model::Game&& game);
+               model::Game&& game,
+               unsigned tick_threads,
+               bool profile_ticks,
+               TickPolicy tick_policy,
+               unsigned max_catch_up_steps);
 
     Strand api_strand_;
     app::Application app_;
-    extra_data::LootTypes loot_types_;
     state_handler::StateHandler state_handler_;
     std::shared_ptr<Ticker> ticker_;
     std::chrono::milliseconds timer_;
+    TickPolicy tick_policy_;
+    unsigned max_catch_up_steps_;
     bool success_restore_ = false;
 
+    std::unique_ptr<net::thread_pool> tick_pool_ = nullptr;
+    SessionStrands session_strands_;
+    SessionsMetrics session_metrics_;
+    SessionsPublishing session_publishing_;
+    //nullptr, если профилирование тика выключено
+    std::unique_ptr<tick_profiler::TickProfiler> tick_profiler_ = nullptr;
+
+    //Обрабатывает запрос в strand сессии. Изменения, сделанные запросами из одной очереди strand,
+    //публикуются одним снимком, и ответы на эти запросы отправляются только после публикации
+    void DispatchToSession(const model::Map::Id& map_id, std::shared_ptr<const StringRequest> request,
+                           targets_storage::TargetRequestType req_type, ResponseSender send);
     std::string ComputeRequestedObject(std::string_view target) const;
+
+    void HandleTickRequest(std::shared_ptr<const StringRequest> req, ResponseSender&& send);
+    //Тик обрабатывается каждой сессией в её strand, завершается в api_strand_
+    void ProcessTick(std::chrono::milliseconds delta, std::function<void()> on_complete);
+    void RecordTickProfile(std::chrono::milliseconds delta, tick_profiler::Clock::duration duration,
+                           const tick_profiler::PhasesDuration& phases);
+    //Собирает состояние сессий по очереди в их strand и записывает его в api_strand_
+    void SaveStateBySessions(size_t session_index, std::shared_ptr<serialization::ApplicationStateRepr> repr);
+
+    ApiResponse MakeApiResponse(const StringRequest& req, app::ResponseInfo resp_info, TimePoint start) const;
 };
 }
\ No newline at end of file
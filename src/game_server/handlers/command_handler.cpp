@@ -15,10 +15,19 @@ std::optional<Args> HandleCommands(int argc, const char *const argv[]) {
         ("help,h", "produce help message")
         ("tick-period,t", po::value(&args.tick_period)->value_name("milliseconds"s), "set tick period")
         ("save-state-period,S", po::value(&args.save_state_period)->value_name("milliseconds"), "set save state period")
+        ("tick-policy", po::value<std::string>()->value_name("skip|catch-up|variable"s), "set handling of ticks that missed their deadline")
+        ("max-catch-up-steps", po::value(&args.max_catch_up_steps)->value_name("count"s), "set maximum number of ticks run in a row by catch-up policy")
+        ("tick-threads", po::value(&args.tick_threads)->value_name("count"s), "set number of threads processing game sessions on tick")
         ("state-file,s", po::value(&args.state_file)->value_name("file"s), "set state file path")
         ("config-file,c", po::value(&args.config_file)->value_name("file"s), "set config file path")
         ("www-root,w", po::value(&args.static_dir)->value_name("dir"s), "set static files root")
-        ("randomize-spawn-points", po::bool_switch(&args.randomize_spawn_point), "spawn dogs at random positions");
+        ("static-cache-size", po::value(&args.static_cache_size)->value_name("megabytes"s), "cache static files in memory up to given size")
+        ("randomize-spawn-points", po::bool_switch(&args.randomize_spawn_point), "spawn dogs at random positions")
+        ("profile-ticks", po::bool_switch(&args.profile_ticks), "measure tick phases and serve recent ticks at /api/v1/debug/ticks")
+        ("random-seed", po::value<uint64_t>()->value_name("seed"s), "set seed for reproducible loot and spawn generation")
+        ("async-log", po::value<std::string>()->value_name("drop|block"s), "write log asynchronously, dropping records or blocking when the queue is full")
+        ("log-sample-rate", po::value(&args.log_sample_rate)->value_name("N"s), "log one of N successful responses")
+        ("log-slow-threshold", po::value<int>()->value_name("milliseconds"s), "always log responses slower than threshold");
     
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -37,6 +46,48 @@ std::optional<Args> HandleCommands(int argc, const char *const argv[]) {
         throw std::runtime_error("Static files directory isn't set!");
     }
 
+    if (vm.contains("random-seed"s)) {
+        args.random_seed = vm["random-seed"s].as<uint64_t>();
+    }
+
+    if (args.log_sample_rate == 0) {
+        throw std::runtime_error("Log sample rate must be positive");
+    }
+
+    if (vm.contains("log-slow-threshold"s)) {
+        args.log_slow_threshold = vm["log-slow-threshold"s].as<int>();
+    }
+
+    if (args.max_catch_up_steps == 0) {
+        throw std::runtime_error("Max catch-up steps must be positive");
+    }
+
+    if (vm.contains("tick-policy"s)) {
+        const auto& policy = vm["tick-policy"s].as<std::string>();
+
+        if (policy == "skip"sv) {
+            args.tick_policy = http_handler::TickPolicy::SKIP;
+        } else if (policy == "catch-up"sv) {
+            args.tick_policy = http_handler::TickPolicy::CATCH_UP;
+        } else if (policy == "variable"sv) {
+            args.tick_policy = http_handler::TickPolicy::VARIABLE;
+        } else {
+            throw std::runtime_error("Unknown tick policy: "s + policy);
+        }
+    }
+
+    if (vm.contains("async-log"s)) {
+        const auto& policy = vm["async-log"s].as<std::string>();
+
+        if (policy == "drop"sv) {
+            args.async_log = logger::OverflowPolicy::DROP;
+        } else if (policy == "block"sv) {
+            args.async_log = logger::OverflowPolicy::BLOCK;
+        } else {
+            throw std::runtime_error("Unknown async log policy: "s + policy);
+        }
+    }
+
     return args;
 }
 }//namespace command_handler
\ No newline at end of file
@@ -2,17 +2,31 @@
 
 #include <boost/program_options.hpp>
 
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include <string>
 
+#include "../server/logger.h"
+#include "ticker.h"
+
 namespace fs = std::filesystem;
 
 namespace command_handler {
 struct Args {
     int tick_period = 0;
     int save_state_period = 0;
+    unsigned tick_threads = 0;
+    std::uintmax_t static_cache_size = 0;
+    std::optional<uint64_t> random_seed;
+    //nullopt, если журнал выводится синхронно
+    std::optional<logger::OverflowPolicy> async_log;
+    unsigned log_sample_rate = 1;
+    std::optional<int> log_slow_threshold;
     bool randomize_spawn_point = false;
+    bool profile_ticks = false;
+    http_handler::TickPolicy tick_policy = http_handler::TickPolicy::VARIABLE;
+    unsigned max_catch_up_steps = http_handler::DEFAULT_MAX_CATCH_UP_STEPS;
     fs::path config_file = "";
     fs::path static_dir = "";
     fs::path state_file = "";
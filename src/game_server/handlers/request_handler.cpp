@@ -17,13 +17,14 @@ using std::string_view;
 
 namespace http_handler {
 const static string_view NO_CACHE = "no-cache";
-const static string_view RESPONSE_SENT = "response sent";
 constexpr static string_view INDEX_FILE_PATH = "index.html"sv;
 
 //_________ReqestHandler_________
-RequestHandler::RequestHandler(fs::path&& base_path, ApiHandler&& api_handler, int save_period)
+RequestHandler::RequestHandler(fs::path&& base_path, ApiHandler&& api_handler, int save_period, 
+                               std::uintmax_t static_cache_size)
     : base_path_(fs::weakly_canonical(base_path))
-    , api_handler_(std::forward<ApiHandler>(api_handler)) {
+    , api_handler_(std::forward<ApiHandler>(api_handler))
+    , file_cache_(static_cache_size) {
     api_handler_.Start(std::chrono::milliseconds(save_period));
 }
 
@@ -42,10 +43,49 @@ BodyResponceVariant RequestHandler::HandleFileRequest(const StringRequest& req,
 
     if(IsSubPath(abs_req_path)) {
         
-        if(auto file = ComputeExistingFile(abs_req_path)) {
+        if(auto cached = file_cache_.Load(abs_req_path)) {
             content_type = ComputeContentType(abs_req_path);
-            status = http::status::ok;
-            response = MakeFileResponse(req, std::move(file.value()), content_type, status);
+            const bool use_gzip = cached->gzip_content && file_cache::AcceptsGzip(req[http::field::accept_encoding]);
+            const auto& etag = use_gzip ? cached->gzip_etag : cached->etag;
+            //Диапазоны отсчитываются в несжатом содержимом
+            auto range = ComputeRange(req, cached->content->size(), cached->etag);
+
+            if(etag::MatchesIfNoneMatch(req[http::field::if_none_match], etag)) {
+                status = http::status::not_modified;
+                response = MakeNotModifiedResponse(req, etag);
+            } else if(range.status == http_range::RangeStatus::SATISFIABLE) {
+                status = http::status::partial_content;
+                response = MakeCachedRangeResponse(req, *cached, 
+                                                   http_range::MakePartialContent(range.ranges, content_type, 
+                                                                                  cached->content->size()));
+            } else if(range.status == http_range::RangeStatus::NOT_SATISFIABLE) {
+                status = http::status::range_not_satisfiable;
+                response = MakeRangeNotSatisfiableResponse(req, cached->content->size());
+            } else {
+                status = http::status::ok;
+                response = MakeCachedFileResponse(req, *cached, use_gzip, content_type);
+            }
+        } else if(auto file = ComputeExistingFile(abs_req_path)) {
+            content_type = ComputeContentType(abs_req_path);
+            auto etag = file_etags_.GetETag(abs_req_path);
+            const auto size = file->GetFileSize();
+            auto range = ComputeRange(req, size, etag.value_or(""s));
+
+            if(etag && etag::MatchesIfNoneMatch(req[http::field::if_none_match], *etag)) {
+                status = http::status::not_modified;
+                response = MakeNotModifiedResponse(req, *etag);
+            } else if(range.status == http_range::RangeStatus::SATISFIABLE) {
+                status = http::status::partial_content;
+                response = MakeFileRangeResponse(req, std::move(file.value()), 
+                                                 http_range::MakePartialContent(range.ranges, content_type, size), 
+                                                 etag);
+            } else if(range.status == http_range::RangeStatus::NOT_SATISFIABLE) {
+                status = http::status::range_not_satisfiable;
+                response = MakeRangeNotSatisfiableResponse(req, size);
+            } else {
+                status = http::status::ok;
+                response = MakeFileResponse(req, std::move(file.value()), content_type, status, etag);
+            }
         } else {
             content_type = ContentType::TEXT_PLAIN;
             status = http::status::not_found;
@@ -58,8 +98,7 @@ BodyResponceVariant RequestHandler::HandleFileRequest(const StringRequest& req,
     }
 
     auto duration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
-    logger::LogExecution(MakeLogResponceJSON(duration, static_cast<unsigned>(status), content_type),
-                                             RESPONSE_SENT);
+    logger::LogResponse(duration, static_cast<int>(status), content_type);
     return response;
 }
 
@@ -98,19 +137,113 @@ StringResponse RequestHandler::HandleErrorRequest(const StringRequest& req, Targ
     response.result(status);
 
     auto duration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
-    logger::LogExecution(MakeLogResponceJSON(duration, static_cast<unsigned>(status), content_type),
-                                             RESPONSE_SENT);
+    logger::LogResponse(duration, static_cast<int>(status), content_type);
     return response;                                                          
 }
 
-FileResponse RequestHandler::MakeFileResponse(const StringRequest& req, http::file_body::value_type&& file, 
-                                              string_view content_type, http::status status) {
+StringResponse RequestHandler::HandleMetricsRequest(const StringRequest& req) {
+    auto start = std::chrono::high_resolution_clock::now();
+    auto status = http::status::ok;
+
+    auto response = MakeStringOtherResponse(status, req, metrics::GetServerMetrics().Render(),
+                                            ContentType::TEXT_PROMETHEUS);
+
+    auto duration = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    logger::LogResponse(duration, static_cast<int>(status), ContentType::TEXT_PROMETHEUS);
+    return response;
+}
+
+FileResponse RequestHandler::MakeFileResponse(const StringRequest& req, http_range::FileRangeBody::value_type&& file, 
+                                              string_view content_type, http::status status,
+                                              const std::optional<string>& etag) {
     FileResponse response; 
 
     response.body() = std::move(file);
     response.version(req.version());
     response.result(status);
     response.insert(http::field::content_type, content_type);
+    response.insert(http::field::accept_ranges, http_range::BYTES);
+    if(etag) {
+        response.insert(http::field::etag, *etag);
+    }
+    response.prepare_payload();
+
+    return response;
+}
+
+FileResponse RequestHandler::MakeFileRangeResponse(const StringRequest& req, http_range::FileRangeBody::value_type&& file,
+                                                   http_range::PartialContent&& partial, 
+                                                   const std::optional<string>& etag) {
+    FileResponse response(http::status::partial_content, req.version());
+
+    response.body() = std::move(file);
+    response.body().SetParts(std::move(partial.parts), std::move(partial.suffix));
+    response.insert(http::field::content_type, partial.content_type);
+    if(partial.content_range) {
+        response.insert(http::field::content_range, *partial.content_range);
+    }
+    response.insert(http::field::accept_ranges, http_range::BYTES);
+    if(etag) {
+        response.insert(http::field::etag, *etag);
+    }
+    response.keep_alive(req.keep_alive());
+    response.prepare_payload();
+
+    return response;
+}
+
+CachedFileResponse RequestHandler::MakeCachedFileResponse(const StringRequest& req, const file_cache::CachedFile& file,
+                                                          bool use_gzip, string_view content_type) {
+    CachedFileResponse response(http::status::ok, req.version());
+
+    response.body() = use_gzip ? file.gzip_content : file.content;
+    response.insert(http::field::content_type, content_type);
+    response.insert(http::field::etag, use_gzip ? file.gzip_etag : file.etag);
+    response.insert(http::field::accept_ranges, http_range::BYTES);
+    if(use_gzip) {
+        response.insert(http::field::content_encoding, file_cache::GZIP);
+    }
+    //Ответ зависит от Accept-Encoding, если у файла есть сжатая версия
+    if(file.gzip_content) {
+        response.insert(http::field::vary, http::to_string(http::field::accept_encoding));
+    }
+    response.keep_alive(req.keep_alive());
+    response.prepare_payload();
+
+    return response;
+}
+
+StringResponse RequestHandler::MakeCachedRangeResponse(const StringRequest& req, const file_cache::CachedFile& file,
+                                                       http_range::PartialContent&& partial) {
+    StringResponse response(http::status::partial_content, req.version());
+
+    response.body() = http_range::AssembleBody(partial, *file.content);
+    response.insert(http::field::content_type, partial.content_type);
+    if(partial.content_range) {
+        response.insert(http::field::content_range, *partial.content_range);
+    }
+    response.insert(http::field::accept_ranges, http_range::BYTES);
+    response.insert(http::field::etag, file.etag);
+    response.keep_alive(req.keep_alive());
+    response.prepare_payload();
+
+    return response;
+}
+
+StringResponse RequestHandler::MakeNotModifiedResponse(const StringRequest& req, const string& etag) {
+    StringResponse response(http::status::not_modified, req.version());
+
+    response.insert(http::field::etag, etag);
+    response.keep_alive(req.keep_alive());
+
+    return response;
+}
+
+StringResponse RequestHandler::MakeRangeNotSatisfiableResponse(const StringRequest& req, std::uint64_t size) {
+    StringResponse response(http::status::range_not_satisfiable, req.version());
+
+    response.insert(http::field::content_range, http_range::MakeUnsatisfiedContentRange(size));
+    response.keep_alive(req.keep_alive());
     response.prepare_payload();
 
     return response;
@@ -185,6 +318,10 @@ TargetRequestType RequestHandler::ComputeRequestType(string_view target) const {
     if(target.starts_with(UsingTargetPath::MAPS)) {
         return target.size() == UsingTargetPath::MAPS.size() ? TargetRequestType::GET_MAPS_INFO
                                                              : TargetRequestType::GET_MAP_BY_ID;
+    } else if(target == UsingTargetPath::METRICS) {
+        return TargetRequestType::GET_METRICS;
+    } else if(target.starts_with(UsingTargetPath::TICK_PROFILE)) {
+        return TargetRequestType::GET_TICK_PROFILE;
     } else if(target.starts_with(UsingTargetPath::RECORDS)){
         return TargetRequestType::GET_RECORDS;
     }else if(target.starts_with(UsingTargetPath::TICK)){
@@ -226,16 +363,25 @@ string_view RequestHandler::ComputeContentType(const fs::path& req_path) const {
     return iter->second;
 }
 
-std::optional<http::file_body::value_type> RequestHandler::ComputeExistingFile(const string& req_path) const {
-    http::file_body::value_type file;
+std::optional<http_range::FileRangeBody::value_type> RequestHandler::ComputeExistingFile(const string& req_path) const {
+    http_range::FileRangeBody::value_type file;
 
-    if (sys::error_code ec; file.open(req_path.data(), beast::file_mode::read, ec), ec) {
+    if (sys::error_code ec; file.Open(req_path.data(), ec), ec) {
         return std::nullopt;
     }
 
     return file;
 }
 
+http_range::RangeRequest RequestHandler::ComputeRange(const StringRequest& req, std::uint64_t size, 
+                                                      string_view etag) const {
+    if(!req.count(http::field::range) || !etag::MatchesIfRange(req[http::field::if_range], etag)) {
+        return {};
+    }
+
+    return http_range::ParseRange(req[http::field::range], size);
+}
+
 bool RequestHandler::IsSubPath(const fs::path& req_path) const {
     for (auto b = base_path_.begin(), p = req_path.begin(); b != base_path_.end(); ++b, ++p) {
         if (p == req_path.end() || *p != *b) {
@@ -17,8 +17,12 @@
 
 #include "../app/application.h"
 #include "../json/json_constructor.h"
+#include "../server/etag.h"
+#include "../server/file_cache.h"
+#include "../server/http_range.h"
 #include "../server/http_server.h"
 #include "../server/logger.h"
+#include "../server/metrics.h"
 #include "api_handler.h"
 #include "target_storage.h"
 
@@ -35,17 +39,20 @@ using namespace std::literals;
 using StringRequest = http::request<http::string_body>;
 // Ответ, тело которого представлено в виде строки
 using StringResponse = http::response<http::string_body>;
-// Ответ, тело которого представлено в виде файла
-using FileResponse = http::response<http::file_body>;
+// Ответ, тело которого представлено в виде файла или его частей
+using FileResponse = http::response<http_range::FileRangeBody>;
+// Ответ, тело которого разделяется с кэшем статических файлов
+using CachedFileResponse = http::response<file_cache::SharedBufferBody>;
 
-using BodyResponceVariant = std::variant<StringResponse, FileResponse>;
+using BodyResponceVariant = std::variant<StringResponse, FileResponse, CachedFileResponse>;
 using Strand = net::strand<net::io_context::executor_type>;
 using Header = http::header<true, beast::http::fields>;
 
 
 class RequestHandler : public std::enable_shared_from_this<RequestHandler> {
 public:
-    explicit RequestHandler(fs::path&& base_path, ApiHandler&& api_handler, int save_period);
+    explicit RequestHandler(fs::path&& base_path, ApiHandler&& api_handler, int save_period, 
+                            std::uintmax_t static_cache_size = 0);
                             
     RequestHandler(const RequestHandler&) = delete;
     RequestHandler& operator=(const RequestHandler&) = delete;
@@ -53,6 +60,7 @@ public:
     template <typename Body, typename Allocator, typename Send>
     void operator()(http::request<Body, http::basic_fields<Allocator>>&& req, Send&& send) {
         using namespace targets_storage;
+        const auto start = metrics::Clock::now();
         auto targ = req.target();
         auto decoded_req_path = DecodeURL(fs::path(std::string(req.target()))).string();                                 
         auto req_type = ComputeRequestType(decoded_req_path);
@@ -78,34 +86,53 @@ public:
                         HandleFileRequest(req, decoded_req_path));
                     break;
                 }
+
+                case TargetRequestType::GET_METRICS : {
+                    send(HandleMetricsRequest(req));
+                    break;
+                }
                 
                 //Будем считать, что по умолчанию /api
                 default : {
-                    auto handle = [self = shared_from_this(), send,
-                                   req = std::forward<decltype(req)>(req), req_type] {
-                        assert(self->api_handler_.GetApiStrand().running_in_this_thread());
-                        return send(self->api_handler_.HanldeApiRequest(req, req_type));
-                    };
-
-                    net::dispatch(api_handler_.GetApiStrand(), handle);
-                    break;
+                    api_handler_.DispatchApiRequest(std::forward<decltype(req)>(req), req_type, 
+                                                    [send, req_type, start](ApiResponse&& response) {
+                                                        send(std::move(response));
+                                                        metrics::GetServerMetrics().ObserveRequest(
+                                                            req_type, metrics::Clock::now() - start);
+                                                    });
+                    return;
                 }
             }
         } else {
             send(HandleErrorRequest(req, req_type));
         }
+
+        metrics::GetServerMetrics().ObserveRequest(req_type, metrics::Clock::now() - start);
     }
 
     void SaveState() const;
 private:
     fs::path base_path_;
     ApiHandler api_handler_;
+    etag::FileETagCache file_etags_;
+    file_cache::FileCache file_cache_;
 
     BodyResponceVariant HandleFileRequest(const StringRequest& req, const fs::path& req_path);
     StringResponse HandleErrorRequest(const StringRequest& req, targets_storage::TargetRequestType req_type);
-
-    FileResponse MakeFileResponse(const StringRequest& req, http::file_body::value_type&& file, 
-                                  std::string_view content_type, http::status status);
+    StringResponse HandleMetricsRequest(const StringRequest& req);
+
+    FileResponse MakeFileResponse(const StringRequest& req, http_range::FileRangeBody::value_type&& file, 
+                                  std::string_view content_type, http::status status,
+                                  const std::optional<std::string>& etag = std::nullopt);
+    FileResponse MakeFileRangeResponse(const StringRequest& req, http_range::FileRangeBody::value_type&& file,
+                                       http_range::PartialContent&& partial, 
+                                       const std::optional<std::string>& etag = std::nullopt);
+    CachedFileResponse MakeCachedFileResponse(const StringRequest& req, const file_cache::CachedFile& file,
+                                              bool use_gzip, std::string_view content_type);
+    StringResponse MakeCachedRangeResponse(const StringRequest& req, const file_cache::CachedFile& file,
+                                           http_range::PartialContent&& partial);
+    StringResponse MakeNotModifiedResponse(const StringRequest& req, const std::string& etag);
+    StringResponse MakeRangeNotSatisfiableResponse(const StringRequest& req, std::uint64_t size);
 
     StringResponse MakeStringOtherResponse(http::status status, const StringRequest& req,
                                            std::string_view message,
@@ -119,7 +146,9 @@ private:
     std::string_view ComputeContentType(const fs::path& req_path) const;
 
     //Возвращает nullopt, если файл не удалось открыть, либо он не существует
-    std::optional<http::file_body::value_type> ComputeExistingFile(const std::string& req_path) const;
+    std::optional<http_range::FileRangeBody::value_type> ComputeExistingFile(const std::string& req_path) const;
+    //Диапазоны учитываются, только если If-Range отсутствует или совпадает с текущим ETag
+    http_range::RangeRequest ComputeRange(const StringRequest& req, std::uint64_t size, std::string_view etag) const;
     
     bool IsSubPath(const fs::path& req_path) const;
     bool ValidateCompability(http::verb method, targets_storage::TargetRequestType req_type) const;
@@ -1,5 +1,6 @@
 #include <memory>
 
+#include "../server/metrics.h"
 #include "state_handler.h"
 
 namespace fs = std::filesystem;
@@ -12,10 +13,15 @@ StateHandler::StateHandler(fs::path&& path) : path_(std::forward<fs::path>(path)
 }
 
 void StateHandler::SaveState(const app::ApplicationState& app_state) const {
+    SaveState(serialization::ApplicationStateRepr(app_state));
+}
+
+void StateHandler::SaveState(const serialization::ApplicationStateRepr& app_state_repr) const {
     if(path_.empty()) {
         return;
     }
 
+    const auto start = metrics::Clock::now();
     std::ofstream out;
     fs::path tmp_file_name_ = "/tmp_" + path_.filename().string();
     fs::path tmp_file_path_ = path_.parent_path().string() + tmp_file_name_.string();
@@ -27,11 +33,11 @@ void StateHandler::SaveState(const app::ApplicationState& app_state) const {
     }
 
     OutputArchive oarchive{out};
-    serialization::ApplicationStateRepr app_state_repr(app_state);
     oarchive << app_state_repr;
     out.close();
 
     fs::rename(tmp_file_path_, path_);
+    metrics::GetServerMetrics().ObserveSaveState(metrics::Clock::now() - start);
 }
 
 bool StateHandler::TryRestoreState(model::Game&& game, app::Application& app) {
@@ -67,9 +73,8 @@ bool StateHandler::TryRestoreState(model::Game&& game, app::Application& app) {
 }
 
 //_________SerrializingListener_________
-SerializingListener::SerializingListener(std::chrono::milliseconds&& save_period, const app::Application& application, Handler handler) 
+SerializingListener::SerializingListener(std::chrono::milliseconds&& save_period, Handler handler) 
     : save_period_(std::forward<std::chrono::milliseconds>(save_period))
-    , app_(application)
     , handler_(handler) {
 }
 
@@ -78,7 +83,7 @@ void SerializingListener::OnTick(const std::chrono::milliseconds& delta) {
 
     time_since_save_ += delta;
     if(time_since_save_ >= save_period_) {
-        handler_(app_.GetApplicationState());
+        handler_();
         time_since_save_ = 0ms;
     }
 }
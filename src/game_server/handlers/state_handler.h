@@ -21,6 +21,7 @@ public:
     explicit StateHandler(std::filesystem::path&& path);
 
     void SaveState(const app::ApplicationState& app_state) const;
+    void SaveState(const serialization::ApplicationStateRepr& app_state_repr) const;
 
     //Если вернул true значит поле, сожержащее путь, не пустое. 
     //В случае пустого файла, или если файл не был найден в Application записываются данные об игре из переданного аргумента.
@@ -31,16 +32,16 @@ private:
 
 class SerializingListener : public app::ApplicationListener {
 public:
-    using Handler = std::function<void(app::ApplicationState)>;
+    //Обработчик сам собирает состояние приложения, т.к. сессии обрабатываются в разных strand
+    using Handler = std::function<void()>;
 
-    SerializingListener(std::chrono::milliseconds&& save_period, const app::Application& application, Handler handler);
+    SerializingListener(std::chrono::milliseconds&& save_period, Handler handler);
 
     void OnTick(const std::chrono::milliseconds& delta) override;
 private:
     std::chrono::milliseconds save_period_{0};
     std::chrono::milliseconds time_since_save_{0};
     
-    const app::Application& app_;
     Handler handler_;
 };
 }//namespace state_handler
\ No newline at end of file
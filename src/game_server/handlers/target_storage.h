@@ -21,6 +21,8 @@ enum class TargetRequestType {
     GET_PLAYERS,
     GET_STATE,
     GET_RECORDS,
+    GET_METRICS,
+    GET_TICK_PROFILE,
     POST_JOIN_GAME,
     POST_ACTION,
     POST_TICK,
@@ -37,7 +39,9 @@ struct UsingTargetPath {
     constexpr static std::string_view JOIN = "/api/v1/game/join";
     constexpr static std::string_view MAPS = "/api/v1/maps";
     constexpr static std::string_view PLAYERS = "/api/v1/game/players";
+    constexpr static std::string_view TICK_PROFILE = "/api/v1/debug/ticks";
     constexpr static std::string_view API = "/api";
+    constexpr static std::string_view METRICS = "/metrics";
 };
 
 struct TargetErrorMessage {
@@ -54,6 +58,7 @@ struct TargetErrorMessage {
     constexpr static std::string_view ERROR_INVALID_ACTION_PARSE_MESSAGE = "Failed to parse action";
     constexpr static std::string_view ERROR_INVALID_TICK_PARSE_MESSAGE = "Failed to parse tick request JSON";
     constexpr static std::string_view ERROR_BAD_REQUEST_MESSAGE = "Bad request";
+    constexpr static std::string_view ERROR_PROFILING_DISABLED_MESSAGE = "Tick profiling is disabled";
 };
 
 struct TargetErrorCode {
@@ -75,6 +80,7 @@ struct ContentType {
     constexpr static std::string_view APPLICATION_JSON = "application/json";
     constexpr static std::string_view APPLICATION_XML = "application/xml";
     constexpr static std::string_view APPLICATION_OCTET = "application/octet-stream";
+    constexpr static std::string_view TEXT_PROMETHEUS = "text/plain; version=0.0.4";
     constexpr static std::string_view IMAGE_PNG = "image/png";
     constexpr static std::string_view IMAGE_JPEG = "image/jpeg";
     constexpr static std::string_view IMAGE_GIF = "image/gif";
@@ -117,6 +123,10 @@ static std::unordered_map<std::string_view, std::vector<http::verb>> allowed_met
                                 http::verb::head}},
     {UsingTargetPath::RECORDS, {http::verb::get,
                                 http::verb::head}},
+    {UsingTargetPath::METRICS, {http::verb::get,
+                                http::verb::head}},
+    {UsingTargetPath::TICK_PROFILE, {http::verb::get,
+                                     http::verb::head}},
     {UsingTargetPath::JOIN,    {http::verb::post}},
     {UsingTargetPath::ACTION,  {http::verb::post}},
     {UsingTargetPath::TICK,    {http::verb::post}}
@@ -130,6 +140,8 @@ static std::unordered_map<http::verb, std::unordered_set<TargetRequestType>> val
                        TargetRequestType::GET_PLAYERS,
                        TargetRequestType::GET_STATE,
                        TargetRequestType::GET_RECORDS,
+                       TargetRequestType::GET_METRICS,
+                       TargetRequestType::GET_TICK_PROFILE,
                        TargetRequestType::ERROR_API,
                       }
     },
@@ -139,6 +151,8 @@ static std::unordered_map<http::verb, std::unordered_set<TargetRequestType>> val
                         TargetRequestType::GET_PLAYERS,
                         TargetRequestType::GET_STATE,
                         TargetRequestType::GET_RECORDS,
+                        TargetRequestType::GET_METRICS,
+                        TargetRequestType::GET_TICK_PROFILE,
                         TargetRequestType::ERROR_API,
                        }
 
@@ -0,0 +1,104 @@
+#include <boost/asio/bind_executor.hpp>
+
+#include <algorithm>
+#include <utility>
+
+#include "ticker.h"
+
+namespace http_handler {
+//_________Ticker_________
+Ticker::Ticker(Strand& strand, const std::chrono::milliseconds& period, Handler handler,
+               TickPolicy policy, unsigned max_catch_up_steps)
+    : strand_(strand)
+    , period_(period)
+    , handler_(handler)
+    , policy_(policy)
+    , max_catch_up_steps_(std::max(max_catch_up_steps, 1u)) {
+}
+
+void Ticker::Start() {
+    last_tick_ = Clock::now();
+    deadline_ = last_tick_ + period_;
+    ScheduleTick();
+}
+
+void Ticker::SetOverrunObserver(OverrunObserver observer) {
+    overrun_observer_ = std::move(observer);
+}
+
+std::uint64_t Ticker::GetOverrunsCount() const noexcept {
+    return overruns_count_;
+}
+
+void Ticker::ScheduleTick() {
+    timer_.expires_at(deadline_);
+    timer_.async_wait(
+        net::bind_executor(strand_, [self = shared_from_this()](sys::error_code ec) {
+            self->OnTick(ec);
+    }));
+}
+
+void Ticker::OnTick(sys::error_code ec) {
+    //Таймер отменяется только при остановке сервера
+    if(ec) {
+        return;
+    }
+
+    const auto now = Clock::now();
+    //Сроки, которые успели пройти после того, на который был заведён таймер
+    const auto missed = static_cast<std::uint64_t>((now - deadline_) / period_);
+
+    deadline_ += period_ * (missed + 1);
+    ScheduleTick();
+
+    pending_periods_ += missed + 1;
+
+    const std::uint64_t overruns = missed + (in_progress_ ? 1 : 0);
+    if(overruns != 0) {
+        overruns_count_ += overruns;
+        if(overrun_observer_) {
+            overrun_observer_(overruns);
+        }
+    }
+
+    //Тик не начинается, пока не обработан предыдущий, наступившие периоды учтутся в следующем
+    if(!in_progress_) {
+        StartTick(now);
+    }
+}
+
+void Ticker::StartTick(Clock::time_point now) {
+    const auto periods = std::exchange(pending_periods_, 0);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_tick_);
+    last_tick_ = now;
+    in_progress_ = true;
+
+    switch (policy_) {
+        case TickPolicy::SKIP :
+            RunSteps(1, period_);
+            break;
+
+        case TickPolicy::CATCH_UP :
+            RunSteps(std::min<std::uint64_t>(periods, max_catch_up_steps_), period_);
+            break;
+
+        case TickPolicy::VARIABLE :
+            RunSteps(1, elapsed);
+            break;
+    }
+}
+
+void Ticker::RunSteps(std::uint64_t steps, std::chrono::milliseconds delta) {
+    handler_(delta, [self = shared_from_this(), steps, delta] {
+        if(steps > 1) {
+            self->RunSteps(steps - 1, delta);
+        } else {
+            self->in_progress_ = false;
+            //Сроки, наступившие во время тика, обрабатываются сразу, не дожидаясь следующего срабатывания таймера
+            if(self->pending_periods_ != 0) {
+                self->StartTick(Clock::now());
+            }
+        }
+    });
+}
+}//namespace http_handler
\ No newline at end of file
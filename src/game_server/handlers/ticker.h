@@ -0,0 +1,71 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace http_handler {
+namespace net = boost::asio;
+namespace sys = boost::system;
+
+using Strand = net::strand<net::io_context::executor_type>;
+
+//Что делать с периодами, тики которых не начались в срок
+enum class TickPolicy {
+    //Пропущенные периоды отбрасываются, тик всегда длится один период
+    SKIP,
+    //Пропущенные периоды обрабатываются подряд тиками длиной в период, но не больше max_catch_up_steps за раз
+    CATCH_UP,
+    //Тик длится столько, сколько прошло с начала предыдущего тика
+    VARIABLE
+};
+
+constexpr static unsigned DEFAULT_MAX_CATCH_UP_STEPS = 4;
+
+//Сроки тиков отсчитываются от запуска с шагом period и не зависят от времени обработки.
+//Срок пропущен, если таймер сработал позже следующего срока либо предыдущий тик ещё обрабатывается
+class Ticker : public std::enable_shared_from_this<Ticker> {
+public:
+    using Clock = std::chrono::steady_clock;
+    //Обработчик вызывает on_complete в strand тикера после того, как тик полностью обработан
+    using Handler = std::function<void(std::chrono::milliseconds delta, std::function<void()> on_complete)>;
+    //Получает число сроков, пропущенных при очередном срабатывании таймера
+    using OverrunObserver = std::function<void(std::uint64_t overruns)>;
+
+    //period должен быть ненулевым
+    Ticker(Strand& strand, const std::chrono::milliseconds& period, Handler handler,
+           TickPolicy policy = TickPolicy::VARIABLE, unsigned max_catch_up_steps = DEFAULT_MAX_CATCH_UP_STEPS);
+
+    void Start();
+    void SetOverrunObserver(OverrunObserver observer);
+
+    std::uint64_t GetOverrunsCount() const noexcept;
+private:
+    void ScheduleTick();
+    void OnTick(sys::error_code ec);
+    void StartTick(Clock::time_point now);
+    //Выполняет steps тиков подряд, каждый следующий — после завершения предыдущего
+    void RunSteps(std::uint64_t steps, std::chrono::milliseconds delta);
+
+private:
+    Strand& strand_;
+    net::steady_timer timer_{strand_};
+    std::chrono::milliseconds period_;
+    Handler handler_;
+    TickPolicy policy_;
+    unsigned max_catch_up_steps_;
+    OverrunObserver overrun_observer_;
+
+    Clock::time_point last_tick_;
+    Clock::time_point deadline_;
+    bool in_progress_ = false;
+    //Периоды, наступившие с начала предыдущего тика
+    std::uint64_t pending_periods_ = 0;
+    std::uint64_t overruns_count_ = 0;
+};
+}//namespace http_handler
\ No newline at end of file
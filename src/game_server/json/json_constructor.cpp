@@ -20,13 +20,13 @@ namespace {
         
         for(const auto& road : roads) {
             json::object road_obj;
-            road_obj[X0] = road->GetStart().x;
-            road_obj[Y0] = road->GetStart().y;
+            road_obj[X0] = road.GetStart().x;
+            road_obj[Y0] = road.GetStart().y;
 
-            if(road->IsHorizontal()) {
-                road_obj[X1] = road->GetEnd().x;
+            if(road.IsHorizontal()) {
+                road_obj[X1] = road.GetEnd().x;
             } else {
-                road_obj[Y1] = road->GetEnd().y;
+                road_obj[Y1] = road.GetEnd().y;
             }
 
             result.push_back(road_obj);
@@ -97,10 +97,10 @@ namespace {
         return result;
     }
 
-    json::object MakeBodyStateDogs(const std::vector<std::shared_ptr<Dog>>& dogs) {
+    json::object MakeBodyStateDogs(const DogStorage& dogs) {
         json::object dogs_obj;
 
-        for(const auto dog_it : dogs) {
+        for(size_t i = 0; i < dogs.size(); ++i) {
             json::array position;
             json::array speed;
             json::array bag;
@@ -108,28 +108,28 @@ namespace {
             json::object dog_info;
             
 
-            CoordObject coord = dog_it->GetCoord();
+            CoordObject coord = dogs.GetCoord(i);
             position.push_back(coord.x);
             position.push_back(coord.y);
 
             dog_info[POSITION] = position;
 
-            SpeedUnit speed_unit = dog_it->GetSpeed();
+            SpeedUnit speed_unit = dogs.GetSpeed(i);
             speed.push_back(speed_unit.horizontal);
             speed.push_back(speed_unit.vertical);
 
             dog_info[SPEED] = speed;
-            dog_info[DIRECTION] = dog_it->GetDirectionToString();
+            dog_info[DIRECTION] = DirectionToString(dogs.GetDirection(i));
             
-            for(const auto& loot_it : dog_it->GetBag()) {
+            for(const auto& loot_it : dogs.GetBag(i)) {
                 loot[ID] = loot_it.GetId();
                 loot[TYPE] = loot_it.GetType();
                 bag.push_back(loot); 
             }
             dog_info[BAG] = bag;
-            dog_info[SCORE] = dog_it->GetScore();
+            dog_info[SCORE] = dogs.GetScore(i);
             
-            dogs_obj[std::to_string(dog_it->GetId())] = dog_info;
+            dogs_obj[std::to_string(dogs.GetId(i))] = dog_info;
         }
 
         return dogs_obj;
@@ -155,6 +155,10 @@ namespace {
 
         return lost_obj;
     }
+
+    double ToMilliseconds(tick_profiler::Clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
 }//namespace
 
 namespace json_constructor {
@@ -193,13 +197,13 @@ string MakeBodyJSON(const player::AuthorizationInfo& object) {
     return json::serialize(result) + "\n" ;
 }
 
-string MakeBodyJSON(const std::vector<std::shared_ptr<Dog>>& dogs) {
+string MakeBodyJSON(const DogStorage& dogs) {
     json::object result;
-    for(const auto dog_it : dogs) {
+    for(size_t i = 0; i < dogs.size(); ++i) {
         json::object dog;  
 
-        dog[NAME] = dog_it->GetName();
-        result[std::to_string(dog_it->GetId())] = dog;
+        dog[NAME] = dogs.GetName(i);
+        result[std::to_string(dogs.GetId(i))] = dog;
     }
  
     return json::serialize(result);
@@ -230,6 +234,35 @@ string MakeBodyJSON(const std::vector<player::PlayerRecord>& records) {
     return json::serialize(result);
 }
 
+string MakeBodyJSON(const tick_profiler::TickProfiler& profiler) {
+    json::array history;
+
+    for(const auto& record : profiler.GetHistory()) {
+        json::object phases;
+        for(size_t i = 0; i < record.phases.size(); ++i) {
+            phases[tick_profiler::ToLabel(static_cast<tick_profiler::Phase>(i))] = ToMilliseconds(record.phases[i]);
+        }
+
+        json::object record_info;
+        record_info[TICK] = record.number;
+        record_info[TIME_DELTA] = record.delta.count();
+        record_info[DURATION] = ToMilliseconds(record.duration);
+        record_info[OVERRUN] = record.overrun;
+        record_info[SLOWEST_PHASE] = tick_profiler::ToLabel(record.GetSlowestPhase());
+        record_info[PHASES] = std::move(phases);
+
+        history.push_back(std::move(record_info));
+    }
+
+    json::object result;
+    result[PERIOD] = profiler.GetPeriod().count();
+    result[TICKS_COUNT] = profiler.GetTicksCount();
+    result[OVERRUNS_COUNT] = profiler.GetOverrunsCount();
+    result[HISTORY] = std::move(history);
+
+    return json::serialize(result) + "\n";
+}
+
 string MakeBodyErrorJSON(string_view error_code,
                          string_view error_message, 
                          const string& req_object) {
@@ -265,32 +298,23 @@ json::object MakeLogStopJSON(int code, const std::optional<string>& exception) {
     return val;
 }
 
-json::object MakeLogRequestJSON(const string& ip, const string& uri, const string& method) {
-    json::object val;
-
-    val[IP] = ip;
-    val[URI] = uri;
-    val[METHOD] = method;
-
-    return val;
-}
-
-json::object MakeLogResponceJSON(int response_time, int code, string_view content_type) {
+json::object MakeLogErrorJSON(int code, const string& text, const string& where) {
     json::object val;
 
-    val[RESPONSE_TIME] = response_time;
     val[CODE] = code;
-    val[CONTENT_TYPE] = string(content_type);
+    val[TEXT] = text;
+    val[WHERE] = where;
 
     return val;
 }
 
-json::object MakeLogErrorJSON(int code, const string& text, const string& where) {
+json::object MakeLogTickOverrunJSON(const tick_profiler::TickRecord& record, std::chrono::milliseconds period) {
     json::object val;
 
-    val[CODE] = code;
-    val[TEXT] = text;
-    val[WHERE] = where;
+    val[TICK] = record.number;
+    val[PERIOD] = period.count();
+    val[DURATION] = ToMilliseconds(record.duration);
+    val[SLOWEST_PHASE] = tick_profiler::ToLabel(record.GetSlowestPhase());
 
     return val;
 }
@@ -14,6 +14,7 @@
 #include "../model/dynamic_object_properties.h"
 #include "../model/game_properties.h"
 #include "../model/static_object_prorerties.h"
+#include "../server/tick_profiler.h"
 #include "json_tags.h"
 
 namespace json_constructor {
@@ -22,9 +23,10 @@ std::string MakeBodyJSON(targets_storage::TargetRequestType req_type,
                          const std::string& req_object = "",
                          const boost::json::array* types = nullptr);
 std::string MakeBodyJSON(const player::AuthorizationInfo& object);
-std::string MakeBodyJSON(const std::vector<std::shared_ptr<model::Dog>>& dogs);
+std::string MakeBodyJSON(const model::DogStorage& dogs);
 std::string MakeBodyJSON(const model::GameState& state);
 std::string MakeBodyJSON(const std::vector<player::PlayerRecord>& records);
+std::string MakeBodyJSON(const tick_profiler::TickProfiler& profiler);
 
 std::string MakeBodyErrorJSON(std::string_view error_code,
                               std::string_view error_message, 
@@ -33,7 +35,6 @@ std::string MakeBodyEmptyObject();
     
 boost::json::object MakeLogStartJSON(int port, const std::string& address);
 boost::json::object MakeLogStopJSON(int code, const std::optional<std::string>& exception = {});
-boost::json::object MakeLogRequestJSON(const std::string& ip, const std::string& uri, const std::string& method);
-boost::json::object MakeLogResponceJSON(int response_time, int code, std::string_view content_type);
 boost::json::object MakeLogErrorJSON(int code, const std::string& text, const std::string& where);
+boost::json::object MakeLogTickOverrunJSON(const tick_profiler::TickRecord& record, std::chrono::milliseconds period);
 }
\ No newline at end of file
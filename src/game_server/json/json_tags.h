@@ -80,6 +80,16 @@ namespace json_tag {
     const static std::string DOG_RETIREMENT_TIME = "dogRetirementTime";
     const static std::string PLAY_TIME = "playTime";
 
+    //tick profile tags
+    const static std::string TICK = "tick";
+    const static std::string TICKS_COUNT = "ticksCount";
+    const static std::string OVERRUNS_COUNT = "overrunsCount";
+    const static std::string HISTORY = "history";
+    const static std::string DURATION = "duration";
+    const static std::string OVERRUN = "overrun";
+    const static std::string PHASES = "phases";
+    const static std::string SLOWEST_PHASE = "slowestPhase";
+
     //other tags
     const static std::string CODE = "code";
     const static std::string MESSAGE = "message";
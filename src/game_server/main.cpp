@@ -24,6 +24,7 @@ using namespace std::literals;
 using namespace http_handler;
 
 constexpr const char DB_URL_ENV_NAME[]{"GAME_DB_URL"};
+constexpr std::uintmax_t BYTES_PER_MEGABYTE = 1024 * 1024;
 
 namespace {
 // Запускает функцию fn на n потоках, включая текущий
@@ -45,9 +46,17 @@ int main(int argc, const char* argv[]) {
 
     try {
          if (auto args = command_handler::HandleCommands(argc, argv)) {
+            if (args->async_log) {
+                logger::StartAsyncLog(*args->async_log);
+            }
+            logger::SetResponseSampling(args->log_sample_rate, args->log_slow_threshold);
+
             // 1. Загружаем карту из файла и построить модель игры
             extra_data::LootTypes loot_types;
             model::Game game = json_loader::LoadGame(args->config_file, loot_types, args->randomize_spawn_point);
+            if (args->random_seed) {
+                game.SetRandomSeed(*args->random_seed);
+            }
             
             const unsigned num_threads = std::thread::hardware_concurrency();
 
@@ -78,11 +87,15 @@ int main(int argc, const char* argv[]) {
                                                                 .SetTimer(std::move(std::chrono::milliseconds(args->tick_period)))
                                                                 .SetStateFile(std::move(args->state_file))
                                                                 .SetDatabaseConfig(std::move(config))
+                                                                .SetTickThreads(args->tick_threads)
+                                                                .SetTickProfiling(args->profile_ticks)
+                                                                .SetTickPolicy(args->tick_policy, args->max_catch_up_steps)
                                                                 .Build();
 
             auto handler = std::make_shared<http_handler::RequestHandler>(std::move(args->static_dir), 
                                                                           std::move(api_handler),
-                                                                          std::move(args->save_state_period));
+                                                                          std::move(args->save_state_period),
+                                                                          args->static_cache_size * BYTES_PER_MEGABYTE);
 
             // 6. Запустить обработчик HTTP-запросов, делегируя их обработчику запросов
             const auto address = net::ip::make_address("0.0.0.0");
@@ -103,8 +116,11 @@ int main(int argc, const char* argv[]) {
         }
     } catch (const std::exception& ex) {
         logger::LogExecution(json_constructor::MakeLogStopJSON(EXIT_FAILURE, ex.what()), "server exited");
+        logger::StopAsyncLog();
         return EXIT_FAILURE;
     }
 
+    logger::StopAsyncLog();
+
     return 0;
 }
@@ -1,7 +1,141 @@
 #include "collision_detector.h"
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 namespace collision_detector {
+namespace {
+// Размер ячейки сетки соответствует шагу дорожной сетки карты
+const static double GRID_CELL_SIZE = 1.0;
+
+using CellKey = uint64_t;
+
+int64_t ComputeCell(double coord) {
+    return static_cast<int64_t>(std::floor(coord / GRID_CELL_SIZE));
+}
+
+// Инвертируем знаковый бит, чтобы порядок ключей совпадал с порядком (cx, cy)
+CellKey MakeCellKey(int64_t cx, int64_t cy) {
+    const uint32_t ux = static_cast<uint32_t>(cx) ^ 0x80000000u;
+    const uint32_t uy = static_cast<uint32_t>(cy) ^ 0x80000000u;
+    return (static_cast<CellKey>(ux) << 32) | uy;
+}
+
+bool IsStaying(const Gatherer& gatherer) {
+    return gatherer.start_pos.x == gatherer.end_pos.x && gatherer.start_pos.y == gatherer.end_pos.y;
+}
+
+//При равном времени порядок событий фиксируется по собирателю и предмету,
+//чтобы результат не зависел от способа перебора
+void SortEvents(std::vector<GatheringEvent>& events) {
+    std::sort(events.begin(), events.end(), [](const GatheringEvent& e_l, const GatheringEvent& e_r) {
+        if (e_l.time != e_r.time) {
+            return e_l.time < e_r.time;
+        }
+        return std::pair(e_l.gatherer_id, e_l.item_id) < std::pair(e_r.gatherer_id, e_r.item_id);
+    });
+}
+
+/*
+ * Все ядра вычисляют одни и те же выражения в одном порядке и без FMA,
+ * поэтому результаты векторного и поэлементного вычисления совпадают побитово.
+ */
+void TryCollectPointsScalar(geom::Point2D a, geom::Point2D b, const double* xs, const double* ys,
+                            double* sq_distances, double* proj_ratios, size_t from, size_t to) {
+    for (size_t i = from; i < to; ++i) {
+        const auto result = TryCollectPoint(a, b, {xs[i], ys[i]});
+        sq_distances[i] = result.sq_distance;
+        proj_ratios[i] = result.proj_ratio;
+    }
+}
+
+#if defined(__SSE2__)
+size_t TryCollectPointsSse2(geom::Point2D a, geom::Point2D b, const double* xs, const double* ys,
+                            double* sq_distances, double* proj_ratios, size_t count) {
+    const __m128d a_x = _mm_set1_pd(a.x);
+    const __m128d a_y = _mm_set1_pd(a.y);
+    const __m128d v_x = _mm_set1_pd(b.x - a.x);
+    const __m128d v_y = _mm_set1_pd(b.y - a.y);
+    const double v_len2_scalar = (b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y);
+    const __m128d v_len2 = _mm_set1_pd(v_len2_scalar);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d u_x = _mm_sub_pd(_mm_loadu_pd(xs + i), a_x);
+        const __m128d u_y = _mm_sub_pd(_mm_loadu_pd(ys + i), a_y);
+        const __m128d u_dot_v = _mm_add_pd(_mm_mul_pd(u_x, v_x), _mm_mul_pd(u_y, v_y));
+        const __m128d u_len2 = _mm_add_pd(_mm_mul_pd(u_x, u_x), _mm_mul_pd(u_y, u_y));
+
+        _mm_storeu_pd(proj_ratios + i, _mm_div_pd(u_dot_v, v_len2));
+        _mm_storeu_pd(sq_distances + i, _mm_sub_pd(u_len2, _mm_div_pd(_mm_mul_pd(u_dot_v, u_dot_v), v_len2)));
+    }
+
+    return i;
+}
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COLLISION_DETECTOR_HAS_AVX2
+__attribute__((target("avx2")))
+size_t TryCollectPointsAvx2(geom::Point2D a, geom::Point2D b, const double* xs, const double* ys,
+                            double* sq_distances, double* proj_ratios, size_t count) {
+    const __m256d a_x = _mm256_set1_pd(a.x);
+    const __m256d a_y = _mm256_set1_pd(a.y);
+    const __m256d v_x = _mm256_set1_pd(b.x - a.x);
+    const __m256d v_y = _mm256_set1_pd(b.y - a.y);
+    const double v_len2_scalar = (b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y);
+    const __m256d v_len2 = _mm256_set1_pd(v_len2_scalar);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d u_x = _mm256_sub_pd(_mm256_loadu_pd(xs + i), a_x);
+        const __m256d u_y = _mm256_sub_pd(_mm256_loadu_pd(ys + i), a_y);
+        const __m256d u_dot_v = _mm256_add_pd(_mm256_mul_pd(u_x, v_x), _mm256_mul_pd(u_y, v_y));
+        const __m256d u_len2 = _mm256_add_pd(_mm256_mul_pd(u_x, u_x), _mm256_mul_pd(u_y, u_y));
+
+        _mm256_storeu_pd(proj_ratios + i, _mm256_div_pd(u_dot_v, v_len2));
+        _mm256_storeu_pd(sq_distances + i,
+                         _mm256_sub_pd(u_len2, _mm256_div_pd(_mm256_mul_pd(u_dot_v, u_dot_v), v_len2)));
+    }
+
+    return i;
+}
+
+bool IsAvx2Supported() {
+    static const bool is_supported = __builtin_cpu_supports("avx2");
+    return is_supported;
+}
+#endif
+
+// Эталон не использует ни сетку, ни пакетные ядра, чтобы не разделять с ними ошибки
+std::vector<GatheringEvent> FindGatherEventsBruteForce(std::span<const Item> items, std::span<const Gatherer> gatherers) {
+    std::vector<GatheringEvent> detected_events;
+
+    for (size_t g = 0; g < gatherers.size(); ++g) {
+        const Gatherer& gatherer = gatherers[g];
+        if (IsStaying(gatherer)) {
+            continue;
+        }
+        for (size_t i = 0; i < items.size(); ++i) {
+            const Item& item = items[i];
+            const auto collect_result = TryCollectPoint(gatherer.start_pos, gatherer.end_pos, item.position);
+
+            if (collect_result.IsCollected(gatherer.width + item.width)) {
+                detected_events.push_back(GatheringEvent{.item_id = i,
+                                                         .gatherer_id = g,
+                                                         .sq_distance = collect_result.sq_distance,
+                                                         .time = collect_result.proj_ratio});
+            }
+        }
+    }
+
+    return detected_events;
+}
+} // namespace
 
 CollectionResult TryCollectPoint(geom::Point2D a, geom::Point2D b, geom::Point2D c) {
     // Проверим, что перемещение ненулевое.
@@ -22,41 +156,184 @@ CollectionResult TryCollectPoint(geom::Point2D a, geom::Point2D b, geom::Point2D
     return CollectionResult(sq_distance, proj_ratio);
 }
 
-std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProviderInterface& provider) {
-    std::vector<GatheringEvent> detected_events;
+void TryCollectPoints(geom::Point2D a, geom::Point2D b,
+                      std::span<const double> xs, std::span<const double> ys,
+                      std::span<double> sq_distances, std::span<double> proj_ratios,
+                      CollectKernel kernel) {
+    assert(b.x != a.x || b.y != a.y);
+    assert(xs.size() == ys.size() && xs.size() <= sq_distances.size() && xs.size() <= proj_ratios.size());
+    const size_t count = xs.size();
+    size_t processed = 0;
 
-    static auto eq_pt = [](geom::Point2D p1, geom::Point2D p2) {
-        return p1.x == p2.x && p1.y == p2.y;
-    };
+    if (kernel == CollectKernel::SIMD) {
+#if defined(COLLISION_DETECTOR_HAS_AVX2)
+        if (IsAvx2Supported()) {
+            processed = TryCollectPointsAvx2(a, b, xs.data(), ys.data(), sq_distances.data(), proj_ratios.data(), count);
+        }
+#endif
+#if defined(__SSE2__)
+        processed += TryCollectPointsSse2(a, b, xs.data() + processed, ys.data() + processed,
+                                          sq_distances.data() + processed, proj_ratios.data() + processed,
+                                          count - processed);
+#endif
+    }
 
-    for (size_t g = 0; g < provider.GatherersCount(); ++g) {
-        Gatherer gatherer = provider.GetGatherer(g);
-        if (eq_pt(gatherer.start_pos, gatherer.end_pos)) {
-            continue;
+    TryCollectPointsScalar(a, b, xs.data(), ys.data(), sq_distances.data(), proj_ratios.data(), processed, count);
+}
+
+//__________ItemGrid__________
+ItemGrid::ItemGrid(std::span<const Item> items) {
+    const size_t items_count = items.size();
+    std::vector<std::pair<CellKey, size_t>> cells;
+    cells.reserve(items_count);
+
+    for (size_t i = 0; i < items_count; ++i) {
+        const Item& item = items[i];
+        const int64_t cx = ComputeCell(item.position.x);
+        const int64_t cy = ComputeCell(item.position.y);
+
+        cells.emplace_back(MakeCellKey(cx, cy), i);
+        max_item_width_ = std::max(max_item_width_, item.width);
+        min_cx_ = std::min(min_cx_, cx);
+        max_cx_ = std::max(max_cx_, cx);
+        min_cy_ = std::min(min_cy_, cy);
+        max_cy_ = std::max(max_cy_, cy);
+    }
+
+    std::sort(cells.begin(), cells.end());
+
+    keys_.reserve(items_count);
+    xs_.reserve(items_count);
+    ys_.reserve(items_count);
+    widths_.reserve(items_count);
+    item_ids_.reserve(items_count);
+
+    for (const auto& [key, item_id] : cells) {
+        keys_.push_back(key);
+        xs_.push_back(items[item_id].position.x);
+        ys_.push_back(items[item_id].position.y);
+        widths_.push_back(items[item_id].width);
+        item_ids_.push_back(item_id);
+    }
+}
+
+size_t ItemGrid::Size() const noexcept {
+    return item_ids_.size();
+}
+
+void ItemGrid::Collect(std::vector<GatheringEvent>& events, const Gatherer& gatherer, size_t gatherer_id,
+                       size_t id_offset, CollectKernel kernel) const {
+    if (keys_.empty()) {
+        return;
+    }
+
+    const double reach = gatherer.width + max_item_width_;
+    const int64_t from_cx = std::max(min_cx_, ComputeCell(std::min(gatherer.start_pos.x, gatherer.end_pos.x) - reach));
+    const int64_t to_cx = std::min(max_cx_, ComputeCell(std::max(gatherer.start_pos.x, gatherer.end_pos.x) + reach));
+    const int64_t from_cy = std::max(min_cy_, ComputeCell(std::min(gatherer.start_pos.y, gatherer.end_pos.y) - reach));
+    const int64_t to_cy = std::min(max_cy_, ComputeCell(std::max(gatherer.start_pos.y, gatherer.end_pos.y) + reach));
+
+    if (from_cx > to_cx || from_cy > to_cy) {
+        return;
+    }
+
+    //Если отрезок покрывает больше строк сетки, чем есть предметов, проще перебрать все предметы
+    if (static_cast<uint64_t>(to_cx - from_cx) >= keys_.size()) {
+        CollectAll(events, gatherer, gatherer_id, id_offset, kernel);
+        return;
+    }
+
+    for (int64_t cx = from_cx; cx <= to_cx; ++cx) {
+        const auto from = std::lower_bound(keys_.begin(), keys_.end(), MakeCellKey(cx, from_cy));
+        const auto to = std::upper_bound(from, keys_.end(), MakeCellKey(cx, to_cy));
+
+        CollectRange(events, gatherer, gatherer_id, id_offset, kernel, from - keys_.begin(), to - keys_.begin());
+    }
+}
+
+void ItemGrid::CollectAll(std::vector<GatheringEvent>& events, const Gatherer& gatherer, size_t gatherer_id,
+                          size_t id_offset, CollectKernel kernel) const {
+    CollectRange(events, gatherer, gatherer_id, id_offset, kernel, 0, Size());
+}
+
+void ItemGrid::CollectRange(std::vector<GatheringEvent>& events, const Gatherer& gatherer, size_t gatherer_id,
+                            size_t id_offset, CollectKernel kernel, size_t from, size_t to) const {
+    const size_t count = to - from;
+    if (count == 0) {
+        return;
+    }
+
+    //Сетка используется только для чтения, в том числе из разных потоков, поэтому буферы результатов у каждого потока свои
+    thread_local std::vector<double> sq_distances;
+    thread_local std::vector<double> proj_ratios;
+    sq_distances.resize(std::max(sq_distances.size(), count));
+    proj_ratios.resize(std::max(proj_ratios.size(), count));
+
+    TryCollectPoints(gatherer.start_pos, gatherer.end_pos,
+                     std::span(xs_).subspan(from, count), std::span(ys_).subspan(from, count),
+                     std::span(sq_distances).first(count), std::span(proj_ratios).first(count),
+                     kernel);
+
+    for (size_t i = 0; i < count; ++i) {
+        const CollectionResult collect_result{sq_distances[i], proj_ratios[i]};
+
+        if (collect_result.IsCollected(gatherer.width + widths_[from + i])) {
+            events.push_back(GatheringEvent{.item_id = item_ids_[from + i] + id_offset,
+                                            .gatherer_id = gatherer_id,
+                                            .sq_distance = collect_result.sq_distance,
+                                            .time = collect_result.proj_ratio});
         }
-        for (size_t i = 0; i < provider.ItemsCount(); ++i) {
-            Item item = provider.GetItem(i);
-            auto collect_result
-                = TryCollectPoint(gatherer.start_pos, gatherer.end_pos, item.position);
+    }
+}
 
-            if (collect_result.IsCollected(gatherer.width + item.width)) {
-                GatheringEvent evt{.item_id = i,
-                                   .gatherer_id = g,
-                                   .sq_distance = collect_result.sq_distance,
-                                   .time = collect_result.proj_ratio};
-                detected_events.push_back(evt);
-            }
+std::vector<GatheringEvent> FindGatherEvents(std::span<const Item> items, const ItemGrid& static_items,
+                                             std::span<const Gatherer> gatherers, CollectKernel kernel) {
+    std::vector<GatheringEvent> detected_events;
+    const ItemGrid grid(items);
+
+    for (size_t g = 0; g < gatherers.size(); ++g) {
+        const Gatherer& gatherer = gatherers[g];
+        if (IsStaying(gatherer)) {
+            continue;
         }
+
+        grid.Collect(detected_events, gatherer, g, 0, kernel);
+        static_items.Collect(detected_events, gatherer, g, items.size(), kernel);
     }
+    SortEvents(detected_events);
 
-    std::sort(detected_events.begin(), detected_events.end(),
-              [](const GatheringEvent& e_l, const GatheringEvent& e_r) {
-                  return e_l.time < e_r.time;
-              });
+    return detected_events;
+}
+
+std::vector<GatheringEvent> FindGatherEvents(std::span<const Item> items, std::span<const Gatherer> gatherers,
+                                             DetectionMode mode, CollectKernel kernel) {
+    if (mode == DetectionMode::SPATIAL_GRID) {
+        return FindGatherEvents(items, ItemGrid(), gatherers, kernel);
+    }
+
+    std::vector<GatheringEvent> detected_events = FindGatherEventsBruteForce(items, gatherers);
+    SortEvents(detected_events);
 
     return detected_events;
 }
 
+std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProviderInterface& provider, DetectionMode mode,
+                                             CollectKernel kernel) {
+    std::vector<Item> items;
+    items.reserve(provider.ItemsCount());
+    for (size_t i = 0; i < provider.ItemsCount(); ++i) {
+        items.push_back(provider.GetItem(i));
+    }
+
+    std::vector<Gatherer> gatherers;
+    gatherers.reserve(provider.GatherersCount());
+    for (size_t g = 0; g < provider.GatherersCount(); ++g) {
+        gatherers.push_back(provider.GetGatherer(g));
+    }
+
+    return FindGatherEvents(items, gatherers, mode, kernel);
+}
+
 ItemGathererProvider::ItemGathererProvider(Items&& items, Gatherers&& gatherers)
     : items_(std::forward<Items>(items))
     , gatherers_(std::forward<Gatherers>(gatherers)) {
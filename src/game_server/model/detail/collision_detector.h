@@ -3,6 +3,8 @@
 #include "geom.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 namespace collision_detector {
@@ -21,6 +23,20 @@ struct CollectionResult {
 // Движемся из точки a в точку b и пытаемся подобрать точку c
 CollectionResult TryCollectPoint(geom::Point2D a, geom::Point2D b, geom::Point2D c);
 
+enum class CollectKernel {
+    // Поэлементное вычисление
+    SCALAR,
+    // Векторные инструкции (AVX2 или SSE2 в зависимости от процессора), остаток обрабатывается поэлементно
+    SIMD
+};
+
+// Пакетный вариант TryCollectPoint для точек c_i = (xs[i], ys[i]).
+// Результаты записываются в sq_distances[i] и proj_ratios[i] и совпадают с результатами TryCollectPoint
+void TryCollectPoints(geom::Point2D a, geom::Point2D b,
+                      std::span<const double> xs, std::span<const double> ys,
+                      std::span<double> sq_distances, std::span<double> proj_ratios,
+                      CollectKernel kernel = CollectKernel::SIMD);
+
 struct Item {
     geom::Point2D position;
     double width;
@@ -66,5 +82,62 @@ public:
     Gatherers gatherers_;
 };
 
-std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProviderInterface& provider);
+enum class DetectionMode {
+    // Полный перебор всех пар собиратель-предмет через TryCollectPoint. Используется как эталон в тестах,
+    // ядро вычислений в этом режиме не учитывается
+    BRUTE_FORCE,
+    // Предварительный отбор предметов по равномерной сетке вокруг отрезка движения собирателя
+    SPATIAL_GRID
+};
+
+/*
+ * Равномерная сетка предметов. Предметы упорядочены по ключу ячейки, поэтому предметы одной строки
+ * сетки (одинаковый cx) лежат в массивах подряд и обрабатываются одним пакетом.
+ * После построения сетка только читается и может использоваться одновременно из нескольких потоков.
+ */
+class ItemGrid {
+public:
+    ItemGrid() = default;
+    explicit ItemGrid(std::span<const Item> items);
+
+    size_t Size() const noexcept;
+
+    // Добавляет события сбора предметов, которые может подобрать собиратель. К id предметов прибавляется id_offset
+    void Collect(std::vector<GatheringEvent>& events, const Gatherer& gatherer, size_t gatherer_id,
+                 size_t id_offset, CollectKernel kernel) const;
+    // То же без отбора по сетке: проверяются все предметы
+    void CollectAll(std::vector<GatheringEvent>& events, const Gatherer& gatherer, size_t gatherer_id,
+                    size_t id_offset, CollectKernel kernel) const;
+private:
+    using CellKey = uint64_t;
+
+    std::vector<CellKey> keys_;
+    std::vector<double> xs_;
+    std::vector<double> ys_;
+    std::vector<double> widths_;
+    std::vector<size_t> item_ids_;
+    double max_item_width_ = 0.;
+    int64_t min_cx_ = INT64_MAX;
+    int64_t max_cx_ = INT64_MIN;
+    int64_t min_cy_ = INT64_MAX;
+    int64_t max_cy_ = INT64_MIN;
+
+    void CollectRange(std::vector<GatheringEvent>& events, const Gatherer& gatherer, size_t gatherer_id,
+                      size_t id_offset, CollectKernel kernel, size_t from, size_t to) const;
+};
+
+// Поиск с заранее построенной сеткой неподвижных предметов. Их id в событиях идут после id предметов items
+std::vector<GatheringEvent> FindGatherEvents(std::span<const Item> items, const ItemGrid& static_items,
+                                             std::span<const Gatherer> gatherers,
+                                             CollectKernel kernel = CollectKernel::SIMD);
+
+// Основной вариант поиска: предметы и собиратели передаются непрерывными массивами без виртуальных вызовов
+std::vector<GatheringEvent> FindGatherEvents(std::span<const Item> items, std::span<const Gatherer> gatherers,
+                                             DetectionMode mode = DetectionMode::SPATIAL_GRID,
+                                             CollectKernel kernel = CollectKernel::SIMD);
+
+// Вариант для произвольных источников данных, например тестовых. Данные один раз копируются в массивы
+std::vector<GatheringEvent> FindGatherEvents(const ItemGathererProviderInterface& provider,
+                                             DetectionMode mode = DetectionMode::SPATIAL_GRID,
+                                             CollectKernel kernel = CollectKernel::SIMD);
 }  // namespace collision_detector
\ No newline at end of file
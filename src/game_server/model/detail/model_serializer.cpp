@@ -63,13 +63,11 @@ model::Dog DogRepr::Restore() const {
 GameSessionRepr::GameSessionRepr(const model::GameSession& session) 
     : map_id_(*session.GetMapId()) {
 
-    auto dogs = session.GetDogs();
-    if(!dogs.empty()) {
-        dogs_.resize(dogs.size());
+    const auto& dogs = session.GetDogs();
+    dogs_.reserve(dogs.size());
 
-        std::transform(dogs.begin(), dogs.end(), dogs_.begin(), [&](const model::DogPtr& dog) {
-            return DogRepr(*dog);
-        });
+    for(size_t i = 0; i < dogs.size(); ++i) {
+        dogs_.emplace_back(dogs.MakeDog(i));
     }
     
     auto lost_objects = session.GetLoot();
@@ -87,14 +85,11 @@ model::Map::Id GameSessionRepr::RestoreMapId() const  {
 }
 
 GameSessionRepr::SessionDogs GameSessionRepr::RestoreDogs() const {
-    std::vector<model::DogPtr> result;
-
-    if(!dogs_.empty()) {
-        result.resize(dogs_.size());
+    SessionDogs result;
+    result.reserve(dogs_.size());
 
-        std::transform(dogs_.begin(), dogs_.end(), result.begin(), [&](const DogRepr& dog_repr) {
-            return std::make_shared<model::Dog>(dog_repr.Restore());
-        });
+    for(const auto& dog_repr : dogs_) {
+        result.push_back(dog_repr.Restore());
     }
     
     return result;
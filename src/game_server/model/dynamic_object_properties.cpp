@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
 #include "dynamic_object_properties.h"
 
 namespace model {
@@ -34,6 +38,65 @@ bool Loot::IsPickedUp() const {
     return is_picked_up_;
 }
 
+//__________LootStore__________
+void LootStore::Add(const Loot& loot) {
+    if(id_to_index_.contains(loot.GetId())) {
+        throw std::invalid_argument("Duplicate loot id");
+    }
+
+    items_.push_back(loot);
+    try {
+        id_to_index_.emplace(loot.GetId(), items_.size() - 1);
+    } catch (...) {
+        items_.pop_back();
+        throw;
+    }
+}
+
+bool LootStore::Remove(size_t id) {
+    auto it = id_to_index_.find(id);
+
+    if(it == id_to_index_.end()) {
+        return false;
+    }
+
+    const size_t index = it->second;
+    id_to_index_.erase(it);
+
+    if(index != items_.size() - 1) {
+        items_[index] = std::move(items_.back());
+        id_to_index_[items_[index].GetId()] = index;
+    }
+    items_.pop_back();
+
+    return true;
+}
+
+void LootStore::Clear() noexcept {
+    items_.clear();
+    id_to_index_.clear();
+}
+
+const Loot* LootStore::Find(size_t id) const {
+    if(auto it = id_to_index_.find(id); it != id_to_index_.end()) {
+        return &items_[it->second];
+    }
+
+    return nullptr;
+}
+
+size_t LootStore::size() const noexcept {
+    return items_.size();
+}
+
+bool LootStore::empty() const noexcept {
+    return items_.empty();
+}
+
+const LootStore::Items& LootStore::GetItems() const noexcept {
+    return items_;
+}
+
 //__________Dog__________
 Dog::Dog(CoordObject coord, const std::string& name, size_t id, size_t bag_capacity) 
     : coord_(coord)
@@ -126,7 +189,23 @@ size_t Dog::GetScore() const {
 }
 
 std::string Dog::GetDirectionToString() const {
-    switch (dir_) {
+    return DirectionToString(dir_);
+}
+
+std::chrono::milliseconds Dog::GetTimeInGame() const {
+    return time_in_game_;
+}
+
+std::chrono::milliseconds Dog::GetInactiveTime() const {
+    return inactive_time_;
+}
+
+bool Dog::IsFullBag() const {
+    return bag_.size() == bag_.capacity();
+}
+
+std::string DirectionToString(Direction dir) {
+    switch (dir) {
         case Direction::U :
             return "U";
 
@@ -144,15 +223,255 @@ std::string Dog::GetDirectionToString() const {
     }
 }
 
-std::chrono::milliseconds Dog::GetTimeInGame() const {
-    return time_in_game_;
+//__________DogStorage__________
+void DogStorage::Add(const Dog& dog) {
+    assert(ids_.empty() || ids_.back() < dog.GetId());
+
+    coords_.push_back(dog.GetCoord());
+    prev_coords_.push_back(dog.GetPrevCoord());
+    speeds_.push_back(dog.GetSpeed());
+    times_in_game_.push_back(dog.GetTimeInGame());
+    inactive_times_.push_back(dog.GetInactiveTime());
+    directions_.push_back(dog.GetDirection());
+    ids_.push_back(dog.GetId());
+
+    bag_capacities_.push_back(dog.GetBagCapacity());
+    Bag& bag = bags_.emplace_back(dog.GetBag());
+    bag.reserve(bag_capacities_.back());
+    names_.push_back(dog.GetName());
+    scores_.push_back(dog.GetScore());
 }
 
-std::chrono::milliseconds Dog::GetInactiveTime() const {
-    return inactive_time_;
+void DogStorage::Erase(size_t index) {
+    coords_.erase(coords_.begin() + index);
+    prev_coords_.erase(prev_coords_.begin() + index);
+    speeds_.erase(speeds_.begin() + index);
+    times_in_game_.erase(times_in_game_.begin() + index);
+    inactive_times_.erase(inactive_times_.begin() + index);
+    directions_.erase(directions_.begin() + index);
+    ids_.erase(ids_.begin() + index);
+
+    bags_.erase(bags_.begin() + index);
+    bag_capacities_.erase(bag_capacities_.begin() + index);
+    names_.erase(names_.begin() + index);
+    scores_.erase(scores_.begin() + index);
 }
 
-bool Dog::IsFullBag() const {
-    return bag_.size() == bag_.capacity();
+std::optional<size_t> DogStorage::FindIndex(size_t id) const {
+    auto id_it = std::lower_bound(ids_.begin(), ids_.end(), id);
+
+    if(id_it == ids_.end() || *id_it != id) {
+        return std::nullopt;
+    }
+
+    return static_cast<size_t>(id_it - ids_.begin());
+}
+
+size_t DogStorage::size() const noexcept {
+    return ids_.size();
+}
+
+bool DogStorage::empty() const noexcept {
+    return ids_.empty();
+}
+
+void DogStorage::UpdateState(size_t index, SpeedUnit speed, Direction dir) {
+    directions_[index] = dir;
+    speeds_[index] = speed;
+}
+
+void DogStorage::Move(size_t index, CoordObject coord) {
+    prev_coords_[index] = coords_[index];
+    coords_[index] = coord;
+}
+
+void DogStorage::LayOutLoot(size_t index) {
+    Bag& bag = bags_[index];
+
+    while(!bag.empty()) {
+        scores_[index] += bag.back().GetCost();
+        bag.pop_back();
+    }
+}
+
+bool DogStorage::TryPickUpLoot(size_t index, const Loot& loot) {
+    Bag& bag = bags_[index];
+
+    if(bag.size() < bag_capacities_[index] && !loot.IsPickedUp()) {
+        bag.push_back(loot);
+        loot.MarkPikedUp();
+        return true;
+    }
+
+    return false;
+}
+
+void DogStorage::SetInactiveTime(size_t index, const std::chrono::milliseconds& time) {
+    inactive_times_[index] = time;
+}
+
+void DogStorage::UpdateTimers(const std::chrono::milliseconds& delta) {
+    for(size_t i = 0; i < ids_.size(); ++i) {
+        times_in_game_[i] += delta;
+
+        const bool is_staying = speeds_[i].horizontal == 0. && speeds_[i].vertical == 0.;
+        inactive_times_[i] = is_staying ? inactive_times_[i] + delta : std::chrono::milliseconds(0);
+    }
+}
+
+const std::string& DogStorage::GetName(size_t index) const {
+    return names_[index];
+}
+
+const DogStorage::Bag& DogStorage::GetBag(size_t index) const {
+    return bags_[index];
+}
+
+size_t DogStorage::GetId(size_t index) const {
+    return ids_[index];
+}
+
+CoordObject DogStorage::GetCoord(size_t index) const {
+    return coords_[index];
+}
+
+CoordObject DogStorage::GetPrevCoord(size_t index) const {
+    return prev_coords_[index];
+}
+
+SpeedUnit DogStorage::GetSpeed(size_t index) const {
+    return speeds_[index];
+}
+
+Direction DogStorage::GetDirection(size_t index) const {
+    return directions_[index];
+}
+
+size_t DogStorage::GetBagCapacity(size_t index) const {
+    return bag_capacities_[index];
+}
+
+size_t DogStorage::GetScore(size_t index) const {
+    return scores_[index];
+}
+
+std::chrono::milliseconds DogStorage::GetTimeInGame(size_t index) const {
+    return times_in_game_[index];
+}
+
+std::chrono::milliseconds DogStorage::GetInactiveTime(size_t index) const {
+    return inactive_times_[index];
+}
+
+const std::vector<CoordObject>& DogStorage::GetCoords() const noexcept {
+    return coords_;
+}
+
+const std::vector<CoordObject>& DogStorage::GetPrevCoords() const noexcept {
+    return prev_coords_;
+}
+
+const std::vector<SpeedUnit>& DogStorage::GetSpeeds() const noexcept {
+    return speeds_;
+}
+
+Dog DogStorage::MakeDog(size_t index) const {
+    Dog dog(prev_coords_[index], names_[index], ids_[index], bag_capacities_[index]);
+
+    dog.Move(coords_[index]);
+    dog.UpdateState(speeds_[index], directions_[index]);
+    dog.AddScore(scores_[index]);
+    dog.SetTimeInGame(times_in_game_[index]);
+    dog.SetInactiveTime(inactive_times_[index]);
+
+    for(const auto& loot : bags_[index]) {
+        dog.AddLoot(loot);
+    }
+
+    return dog;
+}
+
+//__________DogHandle__________
+DogHandle::DogHandle(DogStorage& storage, size_t id)
+    : storage_(&storage)
+    , id_(id) {
+}
+
+void DogHandle::UpdateState(SpeedUnit speed, Direction dir) {
+    storage_->UpdateState(GetIndex(), speed, dir);
+}
+
+void DogHandle::LayOutLoot() {
+    storage_->LayOutLoot(GetIndex());
+}
+
+void DogHandle::TryPickUpLoot(const Loot& loot) {
+    storage_->TryPickUpLoot(GetIndex(), loot);
+}
+
+void DogHandle::SetInactiveTime(const std::chrono::milliseconds& time) {
+    storage_->SetInactiveTime(GetIndex(), time);
+}
+
+const std::string& DogHandle::GetName() const {
+    return storage_->GetName(GetIndex());
+}
+
+const DogStorage::Bag& DogHandle::GetBag() const {
+    return storage_->GetBag(GetIndex());
+}
+
+size_t DogHandle::GetId() const noexcept {
+    return id_;
+}
+
+CoordObject DogHandle::GetCoord() const {
+    return storage_->GetCoord(GetIndex());
+}
+
+CoordObject DogHandle::GetPrevCoord() const {
+    return storage_->GetPrevCoord(GetIndex());
+}
+
+SpeedUnit DogHandle::GetSpeed() const {
+    return storage_->GetSpeed(GetIndex());
+}
+
+Direction DogHandle::GetDirection() const {
+    return storage_->GetDirection(GetIndex());
+}
+
+size_t DogHandle::GetBagCapacity() const {
+    return storage_->GetBagCapacity(GetIndex());
+}
+
+size_t DogHandle::GetScore() const {
+    return storage_->GetScore(GetIndex());
+}
+
+std::string DogHandle::GetDirectionToString() const {
+    return DirectionToString(GetDirection());
+}
+
+std::chrono::milliseconds DogHandle::GetTimeInGame() const {
+    return storage_->GetTimeInGame(GetIndex());
+}
+
+std::chrono::milliseconds DogHandle::GetInactiveTime() const {
+    return storage_->GetInactiveTime(GetIndex());
+}
+
+size_t DogHandle::GetIndex() const {
+    if(index_ < storage_->size() && storage_->GetId(index_) == id_) {
+        return index_;
+    }
+
+    auto index = storage_->FindIndex(id_);
+    if(!index) {
+        throw std::runtime_error("Error search dog");
+    }
+    
+    index_ = *index;
+    return index_;
 }
 } // namespace model
\ No newline at end of file
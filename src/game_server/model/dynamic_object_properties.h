@@ -2,7 +2,9 @@
 
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace model {
@@ -54,6 +56,29 @@ private:
     mutable bool is_picked_up_;
 };
 
+/*
+ * Потерянные предметы сессии. Предметы хранятся в непрерывном массиве в произвольном порядке,
+ * удаление переносит последний предмет на место удалённого, а положение предмета находится по id через индекс.
+ * Поэтому добавление, поиск и удаление предмета выполняются за O(1).
+ */
+class LootStore {
+public:
+    using Items = std::vector<Loot>;
+
+    void Add(const Loot& loot);
+    bool Remove(size_t id);
+    void Clear() noexcept;
+    const Loot* Find(size_t id) const;
+
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    const Items& GetItems() const noexcept;
+private:
+    Items items_;
+    std::unordered_map<size_t, size_t> id_to_index_;
+};
+
 class Dog {
 public:
     using Bag = std::vector<Loot>;
@@ -99,6 +124,100 @@ private:
     bool IsFullBag() const;
 };
 
-using DogPtr = std::shared_ptr<Dog>;
-using ConstDogPtr = std::shared_ptr<const Dog>;
+std::string DirectionToString(Direction dir);
+
+/*
+ * Собаки игровой сессии, разложенные по массивам полей.
+ * Часто используемые при обработке тика данные (координаты, скорости, таймеры) лежат подряд
+ * и не перемежаются редко используемыми (имя, рюкзак, очки).
+ * Собаки упорядочены по id, доступ к отдельной собаке производится по индексу.
+ */
+class DogStorage {
+public:
+    using Bag = Dog::Bag;
+
+    //id добавляемой собаки должен быть больше id всех собак хранилища
+    void Add(const Dog& dog);
+    void Erase(size_t index);
+    std::optional<size_t> FindIndex(size_t id) const;
+
+    size_t size() const noexcept;
+    bool empty() const noexcept;
+
+    void UpdateState(size_t index, SpeedUnit speed, Direction dir);
+    void Move(size_t index, CoordObject coord);
+    void LayOutLoot(size_t index);
+    //Возвращает true, если предмет поместился в рюкзак
+    bool TryPickUpLoot(size_t index, const Loot& loot);
+    void SetInactiveTime(size_t index, const std::chrono::milliseconds& time);
+    //Увеличивает время в игре всех собак и время бездействия стоящих собак
+    void UpdateTimers(const std::chrono::milliseconds& delta);
+
+    const std::string& GetName(size_t index) const;
+    const Bag& GetBag(size_t index) const;
+    size_t GetId(size_t index) const;
+    CoordObject GetCoord(size_t index) const;
+    CoordObject GetPrevCoord(size_t index) const;
+    SpeedUnit GetSpeed(size_t index) const;
+    Direction GetDirection(size_t index) const;
+    size_t GetBagCapacity(size_t index) const;
+    size_t GetScore(size_t index) const;
+    std::chrono::milliseconds GetTimeInGame(size_t index) const;
+    std::chrono::milliseconds GetInactiveTime(size_t index) const;
+
+    const std::vector<CoordObject>& GetCoords() const noexcept;
+    const std::vector<CoordObject>& GetPrevCoords() const noexcept;
+    const std::vector<SpeedUnit>& GetSpeeds() const noexcept;
+
+    //Собирает все поля собаки в отдельный объект, например для сохранения состояния
+    Dog MakeDog(size_t index) const;
+private:
+    std::vector<CoordObject> coords_;
+    std::vector<CoordObject> prev_coords_;
+    std::vector<SpeedUnit> speeds_;
+    std::vector<std::chrono::milliseconds> times_in_game_;
+    std::vector<std::chrono::milliseconds> inactive_times_;
+    std::vector<Direction> directions_;
+    std::vector<size_t> ids_;
+
+    std::vector<Bag> bags_;
+    std::vector<size_t> bag_capacities_;
+    std::vector<std::string> names_;
+    std::vector<size_t> scores_;
+};
+
+/*
+ * Ссылка на собаку в хранилище сессии по её id.
+ * Остаётся действительной при добавлении и удалении других собак, пока существует само хранилище.
+ */
+class DogHandle {
+public:
+    DogHandle() = default;
+    DogHandle(DogStorage& storage, size_t id);
+
+    void UpdateState(SpeedUnit speed, Direction dir);
+    void LayOutLoot();
+    void TryPickUpLoot(const Loot& loot);
+    void SetInactiveTime(const std::chrono::milliseconds& time);
+
+    const std::string& GetName() const;
+    const DogStorage::Bag& GetBag() const;
+    size_t GetId() const noexcept;
+    CoordObject GetCoord() const;
+    CoordObject GetPrevCoord() const;
+    SpeedUnit GetSpeed() const;
+    Direction GetDirection() const;
+    size_t GetBagCapacity() const;
+    size_t GetScore() const;
+    std::string GetDirectionToString() const;
+    std::chrono::milliseconds GetTimeInGame() const;
+    std::chrono::milliseconds GetInactiveTime() const;
+private:
+    DogStorage* storage_ = nullptr;
+    size_t id_ = 0;
+    //Индекс собаки меняется только при удалении собак с меньшим id, поэтому последний найденный индекс запоминается
+    mutable size_t index_ = 0;
+
+    size_t GetIndex() const;
+};
 }//namespace model
\ No newline at end of file
@@ -10,7 +10,6 @@ const static SpeedUnit DEF_SPEED{0.0,0.0};
 
 const static double LOST_OBJECT_WIDTH = 0.0;
 const static double DOG_WIDTH = 0.6;
-const static double OFFICE_WIDTH = 0.6;
 
 using namespace collision_detector;
 using namespace std::literals;
@@ -20,18 +19,22 @@ using std::shared_ptr;
 using std::string;
 
 //__________GameSession__________
-GameSession::GameSession(loot_gen::LootGenerator&& loot_generator, const Map& map) 
+GameSession::GameSession(loot_gen::LootGenerator&& loot_generator, const Map& map, RandomEngine::result_type seed) 
     : loot_generator_(std::forward<LootGenerator>(loot_generator))
+    , random_engine_(seed)
     , map_(map){
+    PublishSnapshot();
 }
 
-shared_ptr<Dog> GameSession::AddDog(const string& name, bool is_random) {  
-    dogs_.emplace_back(std::make_shared<Dog>(is_random ? GenerateRandomPosition()
-                                                       : GetDefPosition(),
-                                             name, 
-                                             next_dog_id_++, 
-                                             map_.GetBagCapacity()));                                                     
-    return dogs_.back();
+DogHandle GameSession::AddDog(const string& name, bool is_random) {  
+    const size_t id = next_dog_id_++;
+    dogs_.Add(Dog(is_random ? GenerateRandomPosition()
+                            : GetDefPosition(),
+                  name, 
+                  id, 
+                  map_.GetBagCapacity()));                                                     
+    MarkChanged();
+    return DogHandle(dogs_, id);
 }
 
 void GameSession::AddDogs(Dogs&& dogs) {
@@ -40,28 +43,50 @@ void GameSession::AddDogs(Dogs&& dogs) {
      *ВАЖНО!!! Не будет работать, если производится сортировка, кроме сортировки по id;
     */
     
-    if(!dogs_.empty()){
-        assert(dogs.front()->GetId() <= dogs.back()->GetId());
-        dogs_ = std::move(dogs);
-        next_dog_id_ = dogs_.back()->GetId() + 1;
+    if(!dogs.empty()){
+        assert(dogs.front().GetId() <= dogs.back().GetId());
+        dogs_ = DogStorage();
+
+        for(const auto& dog : dogs) {
+            dogs_.Add(dog);
+        }
+        next_dog_id_ = dogs.back().GetId() + 1;
+        PublishSnapshot();
     } 
 }
 
 void GameSession::AddLostObjects(LostObjects &&lost_objects) {
     
-    if(!lost_objects_.empty()) {
-        //аналогично ситуации с id собак
-        assert(lost_objects.front().GetId() <= lost_objects.back().GetId());
-
-        lost_objects_ = std::move(lost_objects);
-        next_loot_id_ = lost_objects_.back().GetId() + 1;
+    if(!lost_objects.empty()) {
+        //Порядок предметов в хранилище не совпадает с порядком id, поэтому следующий id вычисляется по наибольшему
+        lost_objects_.Clear();
+        size_t max_id = 0;
+
+        for(const auto& loot : lost_objects) {
+            lost_objects_.Add(loot);
+            max_id = std::max(max_id, loot.GetId());
+        }
+        next_loot_id_ = max_id + 1;
+        PublishSnapshot();
     }
 }
 
 void GameSession::MoveUnits(const std::chrono::milliseconds& delta) {
-    for(auto& dog : dogs_) {
-        const auto position = dog->GetCoord();
-        const auto speed = dog->GetSpeed();
+    MoveDogs(delta);
+    //События сбора всех собак обрабатываются одним проходом в порядке времени
+    ProcessLoot();
+}
+
+void GameSession::MoveDogs(const std::chrono::milliseconds& delta) {
+    //Таймеры учитывают скорость, с которой собаки начали тик
+    dogs_.UpdateTimers(delta);
+
+    const auto& positions = dogs_.GetCoords();
+    const auto& speeds = dogs_.GetSpeeds();
+
+    for(size_t i = 0; i < dogs_.size(); ++i) {
+        const auto position = positions[i];
+        const auto speed = speeds[i];
 
         CoordObject reqested_position = {position.x + speed.horizontal * delta.count() / MILLISECOND_PER_SECOND,
                                          position.y + speed.vertical * delta.count() / MILLISECOND_PER_SECOND};
@@ -69,23 +94,13 @@ void GameSession::MoveUnits(const std::chrono::milliseconds& delta) {
         auto allowed_position = ComputeAllowedPosition(position, reqested_position);
 
         if(allowed_position) {
-            dog->Move(*allowed_position);
+            dogs_.Move(i, *allowed_position);
             
             if(allowed_position->x != reqested_position.x
                || allowed_position->y != reqested_position.y) {
-                dog->UpdateState(DEF_SPEED, Direction::STOP);
+                dogs_.UpdateState(i, DEF_SPEED, Direction::STOP);
             }
         }
-
-        dog->SetTimeInGame(dog->GetTimeInGame() + delta);
-
-        if (speed.horizontal == 0. && speed.vertical == 0.) {
-            dog->SetInactiveTime(dog->GetInactiveTime() + delta);
-        } else {
-            dog->SetInactiveTime(std::chrono::milliseconds(0));
-        }
-
-        ProcessLoot();
     }
 }
 
@@ -95,19 +110,34 @@ void GameSession::GenerateLoot(const std::chrono::milliseconds& delta) {
     for(size_t i = 0; i < new_objects_count; ++i) {
         size_t type = GenerateRandomLootType();
         size_t cost = map_.GetTypeCost(type);
-        lost_objects_.emplace_back(next_loot_id_++, type, cost, GenerateRandomPosition());
+        lost_objects_.Add(Loot(next_loot_id_++, type, cost, GenerateRandomPosition()));
     }
 }
 
-DogPtr GameSession::FindDog(size_t id) {
-    auto dog_it = std::lower_bound(dogs_.begin(), dogs_.end(), id, [](const DogPtr& dog, size_t id) {
-                                                                    return dog->GetId() < id;
-                                                                });
-    if(dog_it == dogs_.end() || dog_it->get()->GetId() != id) {
-        return nullptr;
+void GameSession::ProcessTickActions(const std::chrono::milliseconds& delta, TickPhasesDuration* phases) {
+    {
+        ScopedTickPhase phase(phases, TickPhase::MOVE_UNITS);
+        MoveDogs(delta);
+    }
+    {
+        ScopedTickPhase phase(phases, TickPhase::PROCESS_LOOT);
+        ProcessLoot();
+    }
+    {
+        ScopedTickPhase phase(phases, TickPhase::GENERATE_LOOT);
+        GenerateLoot(delta);
     }
 
-    return *dog_it;
+    //Снимок публикует вызывающий, когда обработка тика сессии полностью завершена
+    MarkChanged();
+}
+
+std::optional<DogHandle> GameSession::FindDog(size_t id) {
+    if(!dogs_.FindIndex(id)) {
+        return std::nullopt;
+    }
+
+    return DogHandle(dogs_, id);
 }
 
 Map::Id GameSession::GetMapId() const {
@@ -118,23 +148,51 @@ const Map& GameSession::GetMap() const {
     return map_;
 }
 
-const std::vector<std::shared_ptr<Dog>>& GameSession::GetDogs() const {
+const DogStorage& GameSession::GetDogs() const {
     return dogs_;
 }
 
-const std::vector<Loot>& GameSession::GetLoot() const {
-    return lost_objects_;
+const LootStore::Items& GameSession::GetLoot() const {
+    return lost_objects_.GetItems();
+}
+
+size_t GameSession::GetGatherEventsCount() const noexcept {
+    return gather_events_count_;
+}
+
+shared_ptr<const SessionSnapshot> GameSession::GetSnapshot() const {
+    return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
 }
 
 void GameSession::DeleteDog(size_t dog_id) {
-    auto dog = std::lower_bound(dogs_.begin(), dogs_.end(), dog_id, [&](const DogPtr& dog, size_t id) {
-                                                                        return dog->GetId() < id;
-                                                                    });
-    if(dog->get()->GetId() != dog_id) {
+    auto index = dogs_.FindIndex(dog_id);
+
+    if(!index) {
         throw std::runtime_error("Error delete dog");
     }
 
-    dogs_.erase(dog);
+    dogs_.Erase(*index);
+    MarkChanged();
+}
+
+void GameSession::MarkChanged() noexcept {
+    changed_ = true;
+}
+
+bool GameSession::PublishSnapshotIfChanged() {
+    if(!changed_) {
+        return false;
+    }
+
+    PublishSnapshot();
+    return true;
+}
+
+void GameSession::PublishSnapshot() {
+    changed_ = false;
+    std::atomic_store_explicit(&snapshot_,
+                               std::make_shared<const SessionSnapshot>(dogs_, lost_objects_.GetItems(), ++snapshot_version_),
+                               std::memory_order_release);
 }
 
 double GameSession::ComputeDistance(CoordObject lhs, CoordObject rhs) const {
@@ -171,97 +229,90 @@ std::optional<CoordObject> GameSession::ComputeAllowedPosition(CoordObject cur_p
 }
 
 void GameSession::ProcessLoot() {
-    const auto& offices = map_.GetOffices();
-
-    ItemGathererProvider::Items items;
-    items.reserve(lost_objects_.size() + offices.size());
+    auto& items = collision_items_;
+    items.clear();
 
-    for (const auto& obj : lost_objects_) {
+    for (const auto& obj : lost_objects_.GetItems()) {
         auto pos = obj.GetPosition();
         items.emplace_back(geom::Point2D{pos.x, pos.y}, LOST_OBJECT_WIDTH/2.);
     }
 
-    size_t offices_start = items.size();
-    for (const auto& office : offices) {
-        auto pos = office.GetPosition();
-        geom::Point2D point{static_cast<double>(pos.x), static_cast<double>(pos.y)};
-        items.emplace_back(point, OFFICE_WIDTH/2.);
-    }
+    //id офисов в событиях идут после id потерянных предметов
+    const size_t offices_start = items.size();
 
-    ItemGathererProvider::Gatherers gatherers;
-    gatherers.reserve(dogs_.size());
+    auto& gatherers = collision_gatherers_;
+    gatherers.clear();
 
-    for (const auto& dog : dogs_) {
-        auto prev_pos = dog->GetPrevCoord();
-        auto new_pos = dog->GetCoord();
-        geom::Point2D prev_pos_2d{prev_pos.x, prev_pos.y};
-        geom::Point2D new_pos_2d{new_pos.x, new_pos.y};
+    const auto& prev_positions = dogs_.GetPrevCoords();
+    const auto& new_positions = dogs_.GetCoords();
+
+    for (size_t i = 0; i < dogs_.size(); ++i) {
+        geom::Point2D prev_pos_2d{prev_positions[i].x, prev_positions[i].y};
+        geom::Point2D new_pos_2d{new_positions[i].x, new_positions[i].y};
         gatherers.emplace_back(prev_pos_2d, new_pos_2d, DOG_WIDTH/2.);
     }
 
-    auto events = FindGatherEvents(ItemGathererProvider(std::move(items), std::move(gatherers)));
+    auto events = FindGatherEvents(items, map_.GetOfficeItems(), gatherers);
+    gather_events_count_ = events.size();
 
     if (events.empty()) {
         return;
     }
 
+    //Предметы удаляются после обработки всех событий, так как события ссылаются на положение предмета в хранилище
+    std::vector<size_t> picked_up_ids;
+
     for (const auto& event : events) {
-        auto& dog = dogs_[event.gatherer_id];
-        auto& bag = dog->GetBag();
+        const size_t dog_index = event.gatherer_id;
 
         if(event.item_id < offices_start) {
-            auto& obj = lost_objects_[event.item_id];
-            dog->TryPickUpLoot(obj);
+            const auto& obj = lost_objects_.GetItems()[event.item_id];
+
+            if(dogs_.TryPickUpLoot(dog_index, obj)) {
+                picked_up_ids.push_back(obj.GetId());
+            }
         } else {
-            if(!bag.empty()) {
-                dog->LayOutLoot();
+            if(!dogs_.GetBag(dog_index).empty()) {
+                dogs_.LayOutLoot(dog_index);
             }
         }
     }
 
-    std::erase_if(lost_objects_, [](const auto& obj) {
-        return obj.IsPickedUp();
-    });
+    for (size_t id : picked_up_ids) {
+        lost_objects_.Remove(id);
+    }
 }
 
 size_t GameSession::GenerateRandomLootType() {
-    std::random_device random_device_;
-    std::mt19937_64 generator(random_device_());
-    std::uniform_int_distribution<> dist(0, map_.GetLootTypesCount() - 1);
+    std::uniform_int_distribution<size_t> dist(0, map_.GetLootTypesCount() - 1);
 
-    return dist(generator);
+    return dist(random_engine_);
 }
 
 const Road &GameSession::GenerateRandomRoad() {
-    std::random_device random_device_;
-    std::mt19937_64 generator(random_device_());
-    std::uniform_int_distribution<> dist(0, map_.GetRoads().size() - 1);
+    std::uniform_int_distribution<size_t> dist(0, map_.GetRoads().size() - 1);
 
-    return *map_.GetRoads()[dist(generator)];
+    return map_.GetRoads()[dist(random_engine_)];
 }
 
 CoordObject GameSession::GenerateRandomPosition() {
-    std::random_device random_device_;
-    auto road = GenerateRandomRoad();
-
-    std::mt19937_64 generator(random_device_());
+    const auto& road = GenerateRandomRoad();
     auto bounds = road.GetBounds();
 
-
     std::uniform_real_distribution<> dist_start_end(bounds.lower, bounds.upper);
     std::uniform_real_distribution<> dist_left_right(bounds.left, bounds.right);
     
-    double gen_start_end = (dist_start_end(generator));
-    double gen_left_right = (dist_left_right(generator));
+    double gen_start_end = (dist_start_end(random_engine_));
+    double gen_left_right = (dist_left_right(random_engine_));
     
     return road.IsHorizontal() ? CoordObject{gen_start_end, gen_left_right}
                                : CoordObject{gen_left_right, gen_start_end};
 }
 
 CoordObject GameSession::GetDefPosition() {
-    auto road = map_.GetRoads()[0];
-    double start_x = static_cast<double>(road->GetStart().x);
-    double start_y = static_cast<double>(road->GetStart().y);
+    const auto& road = map_.GetRoads()[0];
+    double start_x = static_cast<double>(road.GetStart().x);
+    double start_y = static_cast<double>(road.GetStart().y);
     
     return {start_x, start_y};
 }
@@ -289,14 +340,30 @@ void Game::AddMap(Map map) {
 
 std::shared_ptr<GameSession> Game::AddSession(const Map::Id& map_id) {
     int64_t period = static_cast<int64_t>(loot_generator_config_.period * MILLISECOND_PER_SECOND);
+    //Сессии разных карт получают разные, но воспроизводимые последовательности
+    auto seed = random_seed_ ? *random_seed_ + map_id_to_index_.at(map_id)
+                             : std::random_device{}();
     auto game_session = (sessions_.emplace_back(std::make_shared<GameSession>(LootGenerator(std::chrono::milliseconds(period), 
                                                                                             loot_generator_config_.probability),
-                                                                               *FindMap(map_id))));
+                                                                               *FindMap(map_id),
+                                                                               seed)));
     map_id_to_session_.insert({map_id, game_session});
 
     return game_session;
 }
 
+void Game::AddMissingSessions() {
+    for(const auto& map : maps_) {
+        if(!FindGameSessionById(map.GetId())) {
+            AddSession(map.GetId());
+        }
+    }
+}
+
+void Game::SetRandomSeed(GameSession::RandomEngine::result_type seed) {
+    random_seed_ = seed;
+}
+
 UnitParameters Game::PrepareUnitParameters(const Map::Id& map_id, const string& name) {
     auto game_session = FindGameSessionById(map_id);
 
@@ -321,14 +388,7 @@ UnitParameters Game::PrepareUnitParameters(const Map::Id &map_id, size_t dog_id)
        throw std::runtime_error("Error search dog"s);
     }
 
-    return {game_session, dog};
-}
-
-void Game::ProcessTickActions(const std::chrono::milliseconds& delta) const {
-    for(const auto& session : GetSessions()) {
-        session->MoveUnits(delta);
-        session->GenerateLoot(delta);
-    }
+    return {game_session, *dog};
 }
 
 const Map* Game::FindMap(const Map::Id& id) const noexcept {
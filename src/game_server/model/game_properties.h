@@ -1,9 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <random>
 #include <string>
@@ -15,6 +17,7 @@
 #include "detail/loot_generator.h"
 #include "dynamic_object_properties.h"
 #include "static_object_prorerties.h"
+#include "tick_phases.h"
 
 namespace model {
 const static int64_t RETIREMENT_TIME = 60000;
@@ -26,36 +29,92 @@ struct LootGeneratorConfig {
 };
 
 struct GameState {
-    const std::vector<std::shared_ptr<model::Dog>>& dogs;
+    const model::DogStorage& dogs;
     const std::vector<model::Loot>& lost_objects;
 };
 
+//Неизменяемая копия состояния сессии, которую можно читать из любого потока
+struct SessionSnapshot {
+    //Строка, вычисляемая один раз при первом обращении
+    class CachedBody {
+    public:
+        template <typename Fn>
+        const std::string& Get(Fn&& build) const {
+            std::call_once(once_, [&] { 
+                body_ = build(); 
+            });
+            return body_;
+        }
+    private:
+        mutable std::once_flag once_;
+        mutable std::string body_;
+    };
+
+    DogStorage dogs;
+    LootStore::Items lost_objects;
+    //Номер снимка в сессии, увеличивается при каждой публикации
+    uint64_t version = 0;
+
+    //Тела ответов зависят только от снимка, поэтому сериализуются один раз для всех читателей
+    CachedBody state_body;
+    CachedBody players_body;
+};
+
 class GameSession {
 public:
-    using Dogs = std::vector<std::shared_ptr<Dog>>;
+    using Dogs = std::vector<Dog>;
     using LostObjects = std::vector<Loot>;
 
-    GameSession(loot_gen::LootGenerator&& loot_generator, const Map& map);
+    using RandomEngine = std::mt19937_64;
 
-    DogPtr AddDog(const std::string& name, bool is_random);
+    //seed задаёт начальное состояние генератора случайных чисел сессии
+    GameSession(loot_gen::LootGenerator&& loot_generator, const Map& map,
+                RandomEngine::result_type seed = std::random_device{}());
+
+    DogHandle AddDog(const std::string& name, bool is_random);
     void AddDogs(Dogs&& dogs);
     void AddLostObjects(LostObjects&& lost_objects);
 
     void MoveUnits(const std::chrono::milliseconds& delta);
     void GenerateLoot(const std::chrono::milliseconds& delta);
+    //При переданном phases время этапов тика добавляется к соответствующим длительностям
+    void ProcessTickActions(const std::chrono::milliseconds& delta, TickPhasesDuration* phases = nullptr);
 
-    DogPtr FindDog(size_t id);
+    std::optional<DogHandle> FindDog(size_t id);
 
     Map::Id GetMapId() const;
     const Map& GetMap() const;
-    const std::vector<DogPtr>& GetDogs() const;
-    const std::vector<Loot>& GetLoot() const;
+    const DogStorage& GetDogs() const;
+    const LootStore::Items& GetLoot() const;
+    //Число событий сбора, найденных за последний тик
+    size_t GetGatherEventsCount() const noexcept;
+    //Возвращает последний опубликованный снимок; безопасна для вызова из любого потока
+    std::shared_ptr<const SessionSnapshot> GetSnapshot() const;
 
     void DeleteDog(size_t dog_id);
+    //Отмечает изменение, сделанное в обход методов сессии (например, через DogHandle).
+    //Изменения попадают к читателям при следующей публикации снимка
+    void MarkChanged() noexcept;
+    //Публикует снимок, если с прошлой публикации состояние менялось. Возвращает true, если снимок опубликован
+    bool PublishSnapshotIfChanged();
+    //Публикует снимок текущего состояния
+    void PublishSnapshot();
 private:
     loot_gen::LootGenerator loot_generator_;
-    std::vector<DogPtr> dogs_;
-    std::vector<Loot> lost_objects_;
+    RandomEngine random_engine_;
+    DogStorage dogs_;
+    LootStore lost_objects_;
+
+    //Буферы для поиска событий сбора переиспользуются между тиками, чтобы не выделять память заново
+    std::vector<collision_detector::Item> collision_items_;
+    std::vector<collision_detector::Gatherer> collision_gatherers_;
+    size_t gather_events_count_ = 0;
+
+    //Читатели получают снимок без блокировок, а симуляция подменяет его целиком.
+    //Доступ только через std::atomic_load_explicit/std::atomic_store_explicit
+    std::shared_ptr<const SessionSnapshot> snapshot_;
+    uint64_t snapshot_version_ = 0;
+    bool changed_ = false;
 
     const Map& map_;
     size_t next_dog_id_ = 0;
@@ -63,6 +122,7 @@ private:
 
     double ComputeDistance(CoordObject lhs, CoordObject rhs) const;
     std::optional<CoordObject> ComputeAllowedPosition(CoordObject cur_pos, CoordObject new_pos) const;
+    void MoveDogs(const std::chrono::milliseconds& delta);
     void ProcessLoot();
     
     size_t GenerateRandomLootType();
@@ -73,7 +133,7 @@ private:
 
 struct UnitParameters {
     std::shared_ptr<GameSession> session;
-    std::shared_ptr<Dog> dog;
+    DogHandle dog;
 };
 
 class Game {
@@ -86,13 +146,17 @@ public:
 
     void AddMap(Map map);
     std::shared_ptr<GameSession> AddSession(const Map::Id& map_id);
+    //Создаёт сессии для карт, у которых их ещё нет
+    void AddMissingSessions();
+    //Делает генерацию трофеев и позиций воспроизводимой между запусками
+    void SetRandomSeed(GameSession::RandomEngine::result_type seed);
 
     UnitParameters PrepareUnitParameters(const Map::Id& map_id, const std::string& name);
     UnitParameters PrepareUnitParameters(const Map::Id& map_id, size_t dog_id);
-    void ProcessTickActions(const std::chrono::milliseconds& delta) const;
 
     const Map* FindMap(const Map::Id& id) const noexcept;
     Map* FindMap(const Map::Id& id);
+    std::shared_ptr<GameSession> FindGameSessionById(const model::Map::Id& map_id) const;
 
     const Maps& GetMaps() const noexcept;
     const GameSessions& GetSessions() const;
@@ -113,8 +177,8 @@ private:
     
     std::chrono::milliseconds retirement_time_;
     bool randomize_spawn_ = false;
+    std::optional<GameSession::RandomEngine::result_type> random_seed_;
 
-    std::shared_ptr<GameSession> FindGameSessionById(const model::Map::Id& map_id) const;
 };
 
 }//namespace model
\ No newline at end of file
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 #include "static_object_prorerties.h"
@@ -5,31 +7,28 @@
 namespace model {
 using namespace std::literals;
 
-bool ComparatorRoad::operator()(const PairCompareRoad& lhs, const PairCompareRoad& rhs) const {
-    return std::pair(lhs.first, lhs.second) < std::pair(rhs.first, rhs.second); 
-}
-
 //__________Road__________
 Road::Road(HorizontalTag, Point start, Coord end_x) noexcept 
     : start_{start}
-    , end_{end_x, start.y} {
+    , end_{end_x, start.y}
+    , is_horizontal_{true}
+    , is_positive_offset_{start_.x < end_.x}
+    , bounds_{ComputeBounds()}
+    , area_{ComputeArea()} {
 }
 
 Road::Road(VerticalTag, Point start, Coord end_y) noexcept
     : start_{start}
-    , end_{start.x, end_y} {
+    , end_{start.x, end_y}
+    , is_horizontal_{start_.y == end_.y}
+    , is_positive_offset_{is_horizontal_ ? start_.x < end_.x : start_.y < end_.y}
+    , bounds_{ComputeBounds()}
+    , area_{ComputeArea()} {
 }
 
 CoordObject Road::Clamp(CoordObject new_pos) const  {
-    auto bounds = GetBounds();
-    
-    if(IsHorizontal()) {
-        return {std::clamp(new_pos.x, bounds.lower, bounds.upper),
-                std::clamp(new_pos.y, bounds.left, bounds.right)};
-    } 
-    
-    return {std::clamp(new_pos.x, bounds.left, bounds.right),
-            std::clamp(new_pos.y, bounds.lower, bounds.upper)};
+    return {std::clamp(new_pos.x, area_.min_x, area_.max_x),
+            std::clamp(new_pos.y, area_.min_y, area_.max_y)};
 }
 
 Point Road::GetStart() const noexcept {
@@ -40,7 +39,28 @@ Point Road::GetEnd() const noexcept {
     return end_;
 }
 
-Bounds Road::GetBounds() const {
+const Bounds& Road::GetBounds() const noexcept {
+    return bounds_;
+}
+
+bool Road::IsHorizontal() const noexcept {
+    return is_horizontal_;
+}
+
+bool Road::IsVertical() const noexcept {
+    return !is_horizontal_;
+}
+
+bool Road::IsPositiveOffset() const noexcept {
+    return is_positive_offset_;
+}
+
+bool Road::IsCurrectPos(CoordObject pos) const noexcept {
+    return (pos.x >= area_.min_x && pos.y >= area_.min_y)
+            && (pos.x <= area_.max_x && pos.y <= area_.max_y);
+}
+
+Bounds Road::ComputeBounds() const noexcept {
     Bounds result;
 
     if(IsHorizontal()) {
@@ -70,31 +90,12 @@ Bounds Road::GetBounds() const {
     return result;
 }
 
-bool Road::IsHorizontal() const noexcept {
-    return start_.y == end_.y;
-}
-
-bool Road::IsVertical() const noexcept {
-    return start_.x == end_.x;
-}
-
-bool Road::IsPositiveOffset() const noexcept {
+Road::Area Road::ComputeArea() const noexcept {
     if(IsHorizontal()) {
-        return start_.x < end_.x;
-    } 
-    
-    return start_.y < end_.y;
-}
-
-bool Road::IsCurrectPos(CoordObject pos) const {
-    auto bounds = GetBounds();
+        return {bounds_.lower, bounds_.upper, bounds_.left, bounds_.right};
+    }
 
-    if(IsHorizontal()) {
-        return (pos.x >= bounds.lower && pos.y >= bounds.left)  
-                && (pos.x <= bounds.upper && pos.y <= bounds.right);
-    } 
-    return (pos.y >= bounds.lower && pos.x >= bounds.left)
-            && (pos.y <= bounds.upper && pos.x <= bounds.right);
+    return {bounds_.left, bounds_.right, bounds_.lower, bounds_.upper};
 }
 
 //__________Building__________
@@ -132,9 +133,12 @@ Map::Map(Id id, std::string name) noexcept
 }
 
 void Map::AddRoad(const Road& road) {
-    PairCompareRoad key = std::pair<bool, double>(road.IsHorizontal(), road.GetBounds().right);
-    const Road* road_address = &road_to_bound_and_dir.insert({key, road})->second;
-    roads_.push_back(road_address);
+    const size_t index = roads_.size();
+    roads_.push_back(road);
+
+    RoadIndex& road_index = road.IsHorizontal() ? horizontal_roads_ : vertical_roads_;
+    RoadLine road_line{road.IsHorizontal() ? road.GetStart().y : road.GetStart().x, index};
+    road_index.insert(std::upper_bound(road_index.begin(), road_index.end(), road_line), road_line);
 }
 
 void Map::AddBuilding(const Building& building) {
@@ -155,33 +159,15 @@ void Map::AddOffice(Office office) {
         offices_.pop_back();
         throw;
     }
-}
 
-const Map::Roads Map::FindCandidateRoads(CoordObject coord_position) const {
-    Map::Roads result;
-    model::Map::RoadToPair::const_iterator it;
-    
-    it = road_to_bound_and_dir.lower_bound(std::pair(true/*horizontal*/, coord_position.y));
-    if(it != road_to_bound_and_dir.end()) {
-        const auto [begin, end] = road_to_bound_and_dir.equal_range(it->first);
-
-        for(auto iter = begin; iter != end; ++iter) {
-            if(iter->second.IsCurrectPos(coord_position)){
-                result.push_back(&iter->second);
-            }
-        }
-    }
+    UpdateOfficeItems();
+}
 
-    it = road_to_bound_and_dir.lower_bound(std::pair(false/*vertical*/, coord_position.x));
-    if(it != road_to_bound_and_dir.end()) {
-        const auto [begin, end] = road_to_bound_and_dir.equal_range(it->first);
+Map::CandidateRoads Map::FindCandidateRoads(CoordObject coord_position) const {
+    CandidateRoads result;
 
-        for(auto iter = begin; iter != end; ++iter) {
-            if(iter->second.IsCurrectPos(coord_position)){
-                result.push_back(&iter->second);
-            }
-        }
-    }
+    FindRoadsOnLines(horizontal_roads_, coord_position.y, coord_position, result);
+    FindRoadsOnLines(vertical_roads_, coord_position.x, coord_position, result);
     
     return result;
 }
@@ -233,6 +219,36 @@ const Map::Roads& Map::GetRoads() const noexcept {
 const Map::Offices& Map::GetOffices() const noexcept {
     return offices_;
 }
-} // namespace model
 
+const collision_detector::ItemGrid& Map::GetOfficeItems() const noexcept {
+    return office_items_;
+}
+
+void Map::FindRoadsOnLines(const RoadIndex& index, double line_coord, CoordObject pos, CandidateRoads& result) const {
+    //Точка может лежать только на дорогах, линия которых отстоит от неё не дальше MAX_INDENT
+    const auto first_line = static_cast<Coord>(std::ceil(line_coord - MAX_INDENT));
+    const auto last_line = static_cast<Coord>(std::floor(line_coord + MAX_INDENT));
+
+    for(auto it = std::lower_bound(index.begin(), index.end(), RoadLine{first_line, 0});
+        it != index.end() && it->line <= last_line; ++it) {
+        const Road& road = roads_[it->road_index];
 
+        if(road.IsCurrectPos(pos)) {
+            result.push_back(&road);
+        }
+    }
+}
+
+void Map::UpdateOfficeItems() {
+    std::vector<collision_detector::Item> items;
+    items.reserve(offices_.size());
+
+    for (const auto& office : offices_) {
+        auto pos = office.GetPosition();
+        geom::Point2D point{static_cast<double>(pos.x), static_cast<double>(pos.y)};
+        items.emplace_back(point, OFFICE_WIDTH/2.);
+    }
+
+    office_items_ = collision_detector::ItemGrid(items);
+}
+} // namespace model
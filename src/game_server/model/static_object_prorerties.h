@@ -1,16 +1,19 @@
 #pragma once
 
-#include <map>
+#include <boost/container/small_vector.hpp>
+
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "../tagged.h"
+#include "detail/collision_detector.h"
 #include "dynamic_object_properties.h"
 
 namespace model {
 const static double MAX_INDENT = 0.4;
+const static double OFFICE_WIDTH = 0.6;
 
 using Dimension = int;
 using Coord = Dimension;
@@ -39,13 +42,6 @@ struct Offset {
     Dimension dx, dy;
 };
 
-using PairCompareRoad = std::pair<bool, double>;
-
-class ComparatorRoad {
-public:
-    bool operator()(const PairCompareRoad& lhs, const PairCompareRoad& rhs) const;
-};
-
 class Road {
     struct HorizontalTag {
         HorizontalTag() = default;
@@ -66,15 +62,31 @@ public:
 
     Point GetStart() const noexcept;
     Point GetEnd() const noexcept;
-    Bounds GetBounds() const;
+    const Bounds& GetBounds() const noexcept;
 
     bool IsHorizontal() const noexcept;
     bool IsVertical() const noexcept;
     bool IsPositiveOffset() const noexcept;
-    bool IsCurrectPos(CoordObject pos) const;
+    bool IsCurrectPos(CoordObject pos) const noexcept;
 private:
+    //Допустимая для перемещения область дороги в координатах карты
+    struct Area {
+        double min_x;
+        double max_x;
+        double min_y;
+        double max_y;
+    };
+
     Point start_;
     Point end_;
+    //Дорога неизменна, поэтому производные от координат данные вычисляются один раз при создании
+    bool is_horizontal_;
+    bool is_positive_offset_;
+    Bounds bounds_;
+    Area area_;
+
+    Bounds ComputeBounds() const noexcept;
+    Area ComputeArea() const noexcept;
 };
 
 class Building {
@@ -105,7 +117,9 @@ private:
 class Map {
 public:
     using Id = util::Tagged<std::string, Map>;
-    using Roads = std::vector<const Road*>;
+    using Roads = std::vector<Road>;
+    //Дорог, проходящих через одну точку, не больше нескольких, поэтому результат поиска хранится без выделения памяти в куче
+    using CandidateRoads = boost::container::small_vector<const Road*, 4>;
     using Buildings = std::vector<Building>;
     using Offices = std::vector<Office>;
     using LootUnitCost = std::vector<size_t>;
@@ -116,7 +130,7 @@ public:
     void AddBuilding(const Building& building);
     void AddOffice(Office office);
 
-    const Map::Roads FindCandidateRoads(CoordObject coord_position) const;
+    CandidateRoads FindCandidateRoads(CoordObject coord_position) const;
 
     void SetDogSpeed(double speed);
     void SetBagCapacity(size_t capacity);
@@ -133,9 +147,20 @@ public:
     const Roads& GetRoads() const noexcept;
 
     const Offices& GetOffices() const noexcept;
+    //Офисы неподвижны, поэтому сетка для поиска столкновений с ними строится при загрузке карты
+    const collision_detector::ItemGrid& GetOfficeItems() const noexcept;
 private:
     using OfficeIdToIndex = std::unordered_map<Office::Id, size_t, util::TaggedHasher<Office::Id>>;
-    using RoadToPair = std::multimap<PairCompareRoad, const Road, ComparatorRoad>;
+
+    //Линия дороги: y для горизонтальной и x для вертикальной
+    struct RoadLine {
+        Coord line;
+        size_t road_index;
+
+        auto operator<=>(const RoadLine&) const = default;
+    };
+    //Отсортированный по линии индекс дорог одного направления
+    using RoadIndex = std::vector<RoadLine>;
     
     Id id_;
     std::string name_;
@@ -143,12 +168,17 @@ private:
     double dog_speed_;
     size_t bag_capacity_;
     LootUnitCost types_cost_to_index_;
-    RoadToPair road_to_bound_and_dir;
     Roads roads_;
+    RoadIndex horizontal_roads_;
+    RoadIndex vertical_roads_;
     
     Buildings buildings_;
 
     OfficeIdToIndex warehouse_id_to_index_;
     Offices offices_;
+    collision_detector::ItemGrid office_items_;
+
+    void FindRoadsOnLines(const RoadIndex& index, double line_coord, CoordObject pos, CandidateRoads& result) const;
+    void UpdateOfficeItems();
 };
 }// namespace model
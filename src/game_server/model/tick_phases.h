@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace model {
+using TickClock = std::chrono::steady_clock;
+
+//Этапы обработки тика, время которых измеряется при профилировании
+enum class TickPhase {
+    MOVE_UNITS,
+    PROCESS_LOOT,
+    GENERATE_LOOT,
+    PUBLISH_SNAPSHOT,
+    SEND_INTO_RETIREMENT,
+    SET_RECORDS,
+    ON_TICK
+};
+
+constexpr static std::size_t TICK_PHASES_COUNT = static_cast<std::size_t>(TickPhase::ON_TICK) + 1;
+
+using TickPhasesDuration = std::array<TickClock::duration, TICK_PHASES_COUNT>;
+
+//Добавляет время своей жизни к длительности этапа. Без phases время не измеряется,
+//поэтому при выключенном профилировании этапы тика не обращаются к часам
+class ScopedTickPhase {
+public:
+    ScopedTickPhase(TickPhasesDuration* phases, TickPhase phase) noexcept
+        : phases_(phases)
+        , phase_(phase)
+        , start_(phases ? TickClock::now() : TickClock::time_point{}) {
+    }
+
+    ScopedTickPhase(const ScopedTickPhase&) = delete;
+    ScopedTickPhase& operator=(const ScopedTickPhase&) = delete;
+
+    ~ScopedTickPhase() {
+        if(phases_) {
+            (*phases_)[static_cast<std::size_t>(phase_)] += TickClock::now() - start_;
+        }
+    }
+private:
+    TickPhasesDuration* phases_;
+    TickPhase phase_;
+    TickClock::time_point start_;
+};
+}//namespace model
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "etag.h"
+
+namespace fs = std::filesystem;
+
+namespace etag {
+const static uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+const static uint64_t FNV_PRIME = 1099511628211ull;
+const static std::string_view WEAK_PREFIX = "W/";
+const static std::string_view ANY = "*";
+//Размер блока, которым читается файл при вычислении хэша
+const static std::size_t READ_CHUNK_SIZE = 64 * 1024;
+
+namespace {
+std::string ToHex(uint64_t value) {
+    std::stringstream buf;
+    buf << std::hex << std::setw(16) << std::setfill('0') << value;
+    return buf.str();
+}
+
+const std::string& GetLaunchId() {
+    static const std::string launch_id = ToHex(std::random_device{}());
+    return launch_id;
+}
+
+uint64_t UpdateHash(uint64_t hash, std::string_view data) {
+    for(unsigned char c : data) {
+        hash ^= c;
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+std::string Quote(uint64_t hash) {
+    return '"' + ToHex(hash) + '"';
+}
+
+std::string_view Trim(std::string_view value) {
+    const auto first = value.find_first_not_of(" \t");
+    if(first == value.npos) {
+        return {};
+    }
+
+    const auto last = value.find_last_not_of(" \t");
+    return value.substr(first, last - first + 1);
+}
+}// namespace
+
+std::string ComputeETag(std::string_view data) {
+    return Quote(UpdateHash(FNV_OFFSET_BASIS, data));
+}
+
+std::string MakeVersionETag(std::string_view scope, uint64_t version) {
+    std::string result = "\"";
+    result.append(scope);
+    result += '-' + GetLaunchId() + '-' + std::to_string(version) + '"';
+
+    return result;
+}
+
+bool MatchesIfNoneMatch(std::string_view if_none_match, std::string_view etag) {
+    //If-None-Match использует слабое сравнение, поэтому префикс W/ не учитывается
+    while(!if_none_match.empty()) {
+        const auto comma = if_none_match.find(',');
+        auto candidate = Trim(if_none_match.substr(0, comma));
+
+        if(candidate.starts_with(WEAK_PREFIX)) {
+            candidate.remove_prefix(WEAK_PREFIX.size());
+        }
+
+        if(candidate == ANY || candidate == etag) {
+            return true;
+        }
+
+        if(comma == if_none_match.npos) {
+            break;
+        }
+        if_none_match.remove_prefix(comma + 1);
+    }
+
+    return false;
+}
+
+bool MatchesIfRange(std::string_view if_range, std::string_view etag) {
+    if_range = Trim(if_range);
+
+    return if_range.empty() || (!etag.empty() && if_range == etag);
+}
+
+//_________FileETagCache_________
+std::optional<std::string> FileETagCache::GetETag(const fs::path& path) {
+    std::error_code ec;
+    const auto write_time = fs::last_write_time(path, ec);
+    if(ec) {
+        return std::nullopt;
+    }
+
+    const auto size = fs::file_size(path, ec);
+    if(ec) {
+        return std::nullopt;
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        if(auto it = entries_.find(path.string()); it != entries_.end()
+                                                   && it->second.write_time == write_time
+                                                   && it->second.size == size) {
+            return it->second.etag;
+        }
+    }
+
+    //Файл читается вне блокировки, чтобы не задерживать запросы к другим файлам
+    std::ifstream input(path, std::ios::in | std::ios::binary);
+    if(!input) {
+        return std::nullopt;
+    }
+
+    //Хэш считается по блокам, чтобы не держать в памяти весь файл
+    std::vector<char> buffer(READ_CHUNK_SIZE);
+    uint64_t hash = FNV_OFFSET_BASIS;
+    while(input.read(buffer.data(), buffer.size()) || input.gcount() > 0) {
+        hash = UpdateHash(hash, std::string_view(buffer.data(), static_cast<std::size_t>(input.gcount())));
+    }
+    if(input.bad()) {
+        return std::nullopt;
+    }
+
+    std::string etag = Quote(hash);
+
+    std::lock_guard lock(mutex_);
+    entries_.insert_or_assign(path.string(), Entry{write_time, size, etag});
+
+    return etag;
+}
+}//namespace etag
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace etag {
+//Сильный ETag по содержимому. Хэш FNV-1a не зависит от запуска сервера
+std::string ComputeETag(std::string_view data);
+//ETag версии изменяемых данных. Содержит метку запуска сервера, чтобы версии
+//разных запусков не совпадали
+std::string MakeVersionETag(std::string_view scope, uint64_t version);
+//Проверяет значение заголовка If-None-Match: список ETag через запятую или "*"
+bool MatchesIfNoneMatch(std::string_view if_none_match, std::string_view etag);
+//Проверяет значение заголовка If-Range. Допускается только сильное сравнение с ETag,
+//дата в If-Range не поддерживается и считается несовпадением
+bool MatchesIfRange(std::string_view if_range, std::string_view etag);
+
+//Хэш содержимого файла вычисляется при первом запросе и пересчитывается только при изменении файла
+class FileETagCache {
+public:
+    //Возвращает nullopt, если файл не удалось прочитать
+    std::optional<std::string> GetETag(const std::filesystem::path& path);
+private:
+    struct Entry {
+        std::filesystem::file_time_type write_time;
+        std::uintmax_t size;
+        std::string etag;
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+};
+}//namespace etag
\ No newline at end of file
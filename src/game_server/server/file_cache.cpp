@@ -0,0 +1,151 @@
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <fstream>
+#include <iterator>
+#include <mutex>
+
+#include "etag.h"
+#include "file_cache.h"
+
+namespace fs = std::filesystem;
+namespace io = boost::iostreams;
+
+namespace file_cache {
+const static std::string_view ANY = "*";
+const static std::string_view GZIP_ETAG_SUFFIX = "-gzip";
+//Сжатая версия хранится, только если она заметно меньше исходной
+const static double MIN_COMPRESSION_RATIO = 0.9;
+
+namespace {
+std::string CompressGzip(const std::string& data) {
+    std::string result;
+    {
+        io::filtering_ostream out;
+        out.push(io::gzip_compressor(io::gzip_params(io::gzip::best_compression)));
+        out.push(io::back_inserter(result));
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    return result;
+}
+
+std::string_view Trim(std::string_view value) {
+    const auto first = value.find_first_not_of(" \t");
+    if(first == value.npos) {
+        return {};
+    }
+
+    const auto last = value.find_last_not_of(" \t");
+    return value.substr(first, last - first + 1);
+}
+
+//Значение параметра q; кодировка с q=0 запрещена клиентом
+bool IsAllowed(std::string_view params) {
+    const auto pos = params.find("q=");
+    if(pos == params.npos) {
+        return true;
+    }
+
+    return Trim(params.substr(pos + 2)).find_first_not_of("0.") != std::string_view::npos;
+}
+
+//Добавляет к сильному ETag суффикс сжатой версии: "abc" -> "abc-gzip"
+std::string MakeGzipETag(const std::string& etag) {
+    return etag.substr(0, etag.size() - 1).append(GZIP_ETAG_SUFFIX).append("\"");
+}
+}// namespace
+
+//_________FileCache_________
+FileCache::FileCache(std::uintmax_t max_size)
+    : max_size_(max_size) {
+}
+
+std::shared_ptr<const CachedFile> FileCache::Load(const fs::path& path) {
+    if(max_size_ == 0) {
+        return nullptr;
+    }
+
+    const std::string key = path.string();
+    {
+        std::shared_lock lock(mutex_);
+        if(auto it = files_.find(key); it != files_.end()) {
+            return it->second;
+        }
+        if(rejected_.contains(key)) {
+            return nullptr;
+        }
+    }
+
+    std::error_code ec;
+    const auto file_size = fs::file_size(path, ec);
+    if(ec) {
+        return nullptr;
+    }
+    {
+        std::unique_lock lock(mutex_);
+        if(size_ + file_size > max_size_) {
+            rejected_.insert(key);
+            return nullptr;
+        }
+    }
+
+    //Чтение и сжатие выполняются вне блокировки, чтобы не задерживать обращения к другим файлам
+    std::ifstream input(path, std::ios::in | std::ios::binary);
+    if(!input) {
+        return nullptr;
+    }
+
+    auto file = std::make_shared<CachedFile>();
+    auto content = std::make_shared<std::string>(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    file->etag = etag::ComputeETag(*content);
+
+    if(auto compressed = CompressGzip(*content); compressed.size() < content->size() * MIN_COMPRESSION_RATIO) {
+        file->gzip_content = std::make_shared<const std::string>(std::move(compressed));
+        file->gzip_etag = MakeGzipETag(file->etag);
+    }
+    file->content = std::move(content);
+
+    const std::uintmax_t total_size = file->content->size() + (file->gzip_content ? file->gzip_content->size() : 0);
+
+    std::unique_lock lock(mutex_);
+    //Файл мог быть загружен другим потоком, пока этот читал его с диска
+    if(auto it = files_.find(key); it != files_.end()) {
+        return it->second;
+    }
+
+    if(size_ + total_size > max_size_) {
+        rejected_.insert(key);
+        return nullptr;
+    }
+
+    size_ += total_size;
+    return files_.emplace(key, std::move(file)).first->second;
+}
+
+std::uintmax_t FileCache::GetSize() const {
+    std::shared_lock lock(mutex_);
+    return size_;
+}
+
+bool AcceptsGzip(std::string_view accept_encoding) {
+    while(!accept_encoding.empty()) {
+        const auto comma = accept_encoding.find(',');
+        const auto item = accept_encoding.substr(0, comma);
+        const auto semicolon = item.find(';');
+        const auto coding = Trim(item.substr(0, semicolon));
+
+        if(coding == GZIP || coding == ANY) {
+            return semicolon == item.npos || IsAllowed(item.substr(semicolon + 1));
+        }
+
+        if(comma == accept_encoding.npos) {
+            break;
+        }
+        accept_encoding.remove_prefix(comma + 1);
+    }
+
+    return false;
+}
+}//namespace file_cache
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+// boost.beast будет использовать std::string_view вместо boost::string_view
+#define BOOST_BEAST_USE_STD_STRING_VIEW
+
+#include <boost/asio/buffer.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace file_cache {
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+
+constexpr static std::string_view GZIP = "gzip";
+
+//Тело ответа, которое ссылается на неизменяемый буфер кэша и не копирует его
+struct SharedBufferBody {
+    using value_type = std::shared_ptr<const std::string>;
+
+    static std::uint64_t size(const value_type& body) {
+        return body ? body->size() : 0;
+    }
+
+    class writer {
+    public:
+        using const_buffers_type = net::const_buffer;
+
+        template <bool isRequest, typename Fields>
+        writer([[maybe_unused]] const http::header<isRequest, Fields>& header, const value_type& body)
+            : body_(body) {
+        }
+
+        void init(beast::error_code& ec) {
+            ec = {};
+        }
+
+        boost::optional<std::pair<const_buffers_type, bool>> get(beast::error_code& ec) {
+            ec = {};
+
+            if(!body_ || body_->empty()) {
+                return boost::none;
+            }
+
+            return std::make_pair(const_buffers_type(body_->data(), body_->size()), false);
+        }
+    private:
+        const value_type& body_;
+    };
+};
+
+struct CachedFile {
+    std::shared_ptr<const std::string> content;
+    //nullptr, если сжатие не уменьшает размер файла
+    std::shared_ptr<const std::string> gzip_content;
+    std::string etag;
+    std::string gzip_etag;
+};
+
+//Файлы читаются и сжимаются при первом запросе и хранятся до остановки сервера, т.к. 
+//содержимое www-root во время работы не меняется. Файлы, не помещающиеся в лимит, в кэш не попадают
+class FileCache {
+public:
+    //Нулевой лимит отключает кэш
+    explicit FileCache(std::uintmax_t max_size = 0);
+
+    //Возвращает nullptr, если кэш отключён, файл не удалось прочитать или он не помещается в кэш
+    std::shared_ptr<const CachedFile> Load(const std::filesystem::path& path);
+
+    std::uintmax_t GetSize() const;
+private:
+    std::uintmax_t max_size_;
+    std::uintmax_t size_ = 0;
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<const CachedFile>> files_;
+    //Файлы, не поместившиеся в лимит. Кэш только растёт, поэтому они не поместятся и позже,
+    //и повторно не читаются и не сжимаются
+    std::unordered_set<std::string> rejected_;
+};
+
+//Проверяет, допускает ли клиент сжатие gzip, по значению заголовка Accept-Encoding
+bool AcceptsGzip(std::string_view accept_encoding);
+}//namespace file_cache
\ No newline at end of file
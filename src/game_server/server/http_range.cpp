@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+#include "http_range.h"
+
+namespace http_range {
+//Запросы с большим числом диапазонов обслуживаются целым файлом, чтобы один запрос
+//не порождал тысячи частей
+const static std::size_t MAX_RANGES = 32;
+const static std::string_view MULTIPART_BYTERANGES = "multipart/byteranges; boundary=";
+const static std::string_view CRLF = "\r\n";
+const static std::string_view BOUNDARY_DASHES = "--";
+
+namespace {
+std::string_view Trim(std::string_view value) {
+    const auto first = value.find_first_not_of(" \t");
+    if(first == value.npos) {
+        return {};
+    }
+
+    const auto last = value.find_last_not_of(" \t");
+    return value.substr(first, last - first + 1);
+}
+
+std::optional<std::uint64_t> ParseNumber(std::string_view value) {
+    std::uint64_t result = 0;
+    const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+
+    if(value.empty() || ec != std::errc() || ptr != value.data() + value.size()) {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+//Разбирает один элемент списка: "first-last", "first-" или "-suffix_length".
+//Возвращает nullopt для синтаксически неверного элемента и пустой отрезок для невыполнимого
+std::optional<std::optional<ByteRange>> ParseRangeSpec(std::string_view spec, std::uint64_t size) {
+    const auto dash = spec.find('-');
+    if(dash == spec.npos) {
+        return std::nullopt;
+    }
+
+    const auto first_str = spec.substr(0, dash);
+    const auto last_str = spec.substr(dash + 1);
+
+    if(first_str.empty()) {
+        auto suffix_length = ParseNumber(last_str);
+        if(!suffix_length) {
+            return std::nullopt;
+        }
+
+        if(*suffix_length == 0 || size == 0) {
+            return std::optional<ByteRange>{};
+        }
+
+        return ByteRange{size - std::min(*suffix_length, size), size - 1};
+    }
+
+    auto first = ParseNumber(first_str);
+    if(!first) {
+        return std::nullopt;
+    }
+
+    std::uint64_t last = size - 1;
+    if(!last_str.empty()) {
+        auto parsed_last = ParseNumber(last_str);
+        if(!parsed_last || *parsed_last < *first) {
+            return std::nullopt;
+        }
+        last = std::min(*parsed_last, last);
+    }
+
+    if(*first >= size) {
+        return std::optional<ByteRange>{};
+    }
+
+    return ByteRange{*first, last};
+}
+
+//Объединяет пересекающиеся и соседние диапазоны, RFC 9110 допускает это для любого порядка
+Ranges Coalesce(Ranges ranges) {
+    std::sort(ranges.begin(), ranges.end());
+
+    Ranges result;
+    for(const auto& range : ranges) {
+        if(!result.empty() && range.first <= result.back().last + 1) {
+            result.back().last = std::max(result.back().last, range.last);
+        } else {
+            result.push_back(range);
+        }
+    }
+
+    return result;
+}
+
+std::string MakeContentRange(const ByteRange& range, std::uint64_t size) {
+    std::string result(BYTES);
+    result += ' ' + std::to_string(range.first) + '-' + std::to_string(range.last) + '/' + std::to_string(size);
+
+    return result;
+}
+
+std::string MakeBoundary() {
+    thread_local std::mt19937_64 generator{std::random_device{}()};
+
+    std::stringstream buf;
+    buf << std::hex << std::setw(16) << std::setfill('0') << generator();
+    return buf.str();
+}
+}// namespace
+
+RangeRequest ParseRange(std::string_view range, std::uint64_t size) {
+    range = Trim(range);
+
+    const auto eq = range.find('=');
+    if(eq == range.npos
+       || !std::equal(BYTES.begin(), BYTES.end(), range.begin(), range.begin() + eq,
+                      [](char lhs, char rhs) {
+                          return lhs == std::tolower(static_cast<unsigned char>(rhs));
+                      })) {
+        return {};
+    }
+    range.remove_prefix(eq + 1);
+
+    Ranges satisfiable;
+    std::size_t specs_count = 0;
+
+    while(!range.empty()) {
+        const auto comma = range.find(',');
+        const auto spec = Trim(range.substr(0, comma));
+        range.remove_prefix(comma == range.npos ? range.size() : comma + 1);
+
+        //Пустые элементы списка допускаются грамматикой и пропускаются
+        if(spec.empty()) {
+            continue;
+        }
+
+        if(++specs_count > MAX_RANGES) {
+            return {};
+        }
+
+        auto parsed = ParseRangeSpec(spec, size);
+        if(!parsed) {
+            return {};
+        }
+
+        if(*parsed) {
+            satisfiable.push_back(**parsed);
+        }
+    }
+
+    if(specs_count == 0) {
+        return {};
+    }
+
+    if(satisfiable.empty()) {
+        return {RangeStatus::NOT_SATISFIABLE, {}};
+    }
+
+    return {RangeStatus::SATISFIABLE, Coalesce(std::move(satisfiable))};
+}
+
+//_________FileRangeBody_________
+void FileRangeBody::value_type::Open(const char* path, beast::error_code& ec) {
+    file_.open(path, beast::file_mode::read, ec);
+    if(ec) {
+        return;
+    }
+
+    file_size_ = file_.size(ec);
+    if(ec) {
+        return;
+    }
+
+    parts_ = {Part{{}, 0, file_size_}};
+    suffix_.clear();
+}
+
+void FileRangeBody::value_type::SetParts(Parts parts, std::string suffix) {
+    parts_ = std::move(parts);
+    suffix_ = std::move(suffix);
+}
+
+bool FileRangeBody::value_type::IsOpen() const {
+    return file_.is_open();
+}
+
+std::uint64_t FileRangeBody::value_type::GetFileSize() const noexcept {
+    return file_size_;
+}
+
+std::uint64_t FileRangeBody::value_type::GetSize() const noexcept {
+    return std::accumulate(parts_.begin(), parts_.end(), static_cast<std::uint64_t>(suffix_.size()),
+                           [](std::uint64_t sum, const Part& part) {
+                               return sum + part.prefix.size() + part.length;
+                           });
+}
+
+bool FileRangeBody::value_type::IsSingleSegment() const noexcept {
+    return parts_.size() == 1 && parts_.front().prefix.empty() && suffix_.empty();
+}
+
+beast::file& FileRangeBody::value_type::GetFile() noexcept {
+    return file_;
+}
+
+const FileRangeBody::Parts& FileRangeBody::value_type::GetParts() const noexcept {
+    return parts_;
+}
+
+const std::string& FileRangeBody::value_type::GetSuffix() const noexcept {
+    return suffix_;
+}
+
+boost::optional<std::pair<FileRangeBody::writer::const_buffers_type, bool>>
+FileRangeBody::writer::get(beast::error_code& ec) {
+    ec = {};
+    const auto& parts = body_.GetParts();
+
+    while(part_index_ < parts.size()) {
+        const auto& part = parts[part_index_];
+
+        if(!prefix_sent_) {
+            prefix_sent_ = true;
+            if(!part.prefix.empty()) {
+                return std::make_pair(const_buffers_type(part.prefix.data(), part.prefix.size()), true);
+            }
+        }
+
+        if(part_pos_ < part.length) {
+            if(part_pos_ == 0) {
+                body_.GetFile().seek(part.offset, ec);
+                if(ec) {
+                    return boost::none;
+                }
+            }
+
+            const auto amount = static_cast<std::size_t>(std::min<std::uint64_t>(part.length - part_pos_, BUFFER_SIZE));
+            const auto read = body_.GetFile().read(buffer_.data(), amount, ec);
+            if(ec) {
+                return boost::none;
+            }
+
+            //Файл оказался короче, чем при открытии
+            if(read == 0) {
+                ec = http::error::short_read;
+                return boost::none;
+            }
+
+            part_pos_ += read;
+            return std::make_pair(const_buffers_type(buffer_.data(), read), true);
+        }
+
+        ++part_index_;
+        prefix_sent_ = false;
+        part_pos_ = 0;
+    }
+
+    const auto& suffix = body_.GetSuffix();
+    if(!suffix_sent_ && !suffix.empty()) {
+        suffix_sent_ = true;
+        return std::make_pair(const_buffers_type(suffix.data(), suffix.size()), false);
+    }
+
+    return boost::none;
+}
+
+//_________PartialContent_________
+PartialContent MakePartialContent(const Ranges& ranges, std::string_view content_type, std::uint64_t size) {
+    PartialContent result;
+
+    if(ranges.size() == 1) {
+        result.content_type = content_type;
+        result.content_range = MakeContentRange(ranges.front(), size);
+        result.parts.push_back({{}, ranges.front().first, ranges.front().Length()});
+
+        return result;
+    }
+
+    const auto boundary = MakeBoundary();
+    result.content_type = std::string(MULTIPART_BYTERANGES) + boundary;
+
+    for(const auto& range : ranges) {
+        std::string prefix;
+        //Тело каждой части, кроме последней, отделяется от следующей границы переводом строки
+        if(!result.parts.empty()) {
+            prefix += CRLF;
+        }
+        prefix.append(BOUNDARY_DASHES).append(boundary).append(CRLF);
+        prefix.append(http::to_string(http::field::content_type)).append(": ").append(content_type).append(CRLF);
+        prefix.append(http::to_string(http::field::content_range)).append(": ")
+              .append(MakeContentRange(range, size)).append(CRLF);
+        prefix += CRLF;
+
+        result.parts.push_back({std::move(prefix), range.first, range.Length()});
+    }
+
+    result.suffix.append(CRLF).append(BOUNDARY_DASHES).append(boundary).append(BOUNDARY_DASHES).append(CRLF);
+
+    return result;
+}
+
+std::string AssembleBody(const PartialContent& partial, std::string_view content) {
+    std::string result;
+
+    for(const auto& part : partial.parts) {
+        result += part.prefix;
+        result += content.substr(part.offset, part.length);
+    }
+    result += partial.suffix;
+
+    return result;
+}
+
+std::string MakeUnsatisfiedContentRange(std::uint64_t size) {
+    std::string result(BYTES);
+    result += " */" + std::to_string(size);
+
+    return result;
+}
+}//namespace http_range
\ No newline at end of file
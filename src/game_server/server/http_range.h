@@ -0,0 +1,134 @@
+#pragma once
+
+// boost.beast будет использовать std::string_view вместо boost::string_view
+#define BOOST_BEAST_USE_STD_STRING_VIEW
+
+#include <boost/asio/buffer.hpp>
+#include <boost/beast/core/file.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/optional.hpp>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace http_range {
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+
+constexpr static std::string_view BYTES = "bytes";
+
+//Отрезок [first, last] включительно, как в заголовке Range
+struct ByteRange {
+    std::uint64_t first;
+    std::uint64_t last;
+
+    std::uint64_t Length() const noexcept {
+        return last - first + 1;
+    }
+
+    auto operator<=>(const ByteRange&) const = default;
+};
+
+using Ranges = std::vector<ByteRange>;
+
+enum class RangeStatus {
+    //Заголовка нет, либо он некорректен и по RFC 9110 игнорируется: отдаётся весь файл
+    NONE,
+    SATISFIABLE,
+    NOT_SATISFIABLE
+};
+
+struct RangeRequest {
+    RangeStatus status = RangeStatus::NONE;
+    //Отсортированные диапазоны без пересечений
+    Ranges ranges;
+};
+
+//Разбирает значение заголовка Range для ресурса размером size
+RangeRequest ParseRange(std::string_view range, std::uint64_t size);
+
+//Тело ответа из частей файла, которое читается с диска по мере отправки.
+//Каждой части может предшествовать заголовок части multipart/byteranges
+struct FileRangeBody {
+    struct Part {
+        std::string prefix;
+        std::uint64_t offset = 0;
+        std::uint64_t length = 0;
+    };
+
+    using Parts = std::vector<Part>;
+
+    class value_type {
+    public:
+        //После открытия тело содержит весь файл
+        void Open(const char* path, beast::error_code& ec);
+        void SetParts(Parts parts, std::string suffix = {});
+
+        bool IsOpen() const;
+        std::uint64_t GetFileSize() const noexcept;
+        std::uint64_t GetSize() const noexcept;
+        //Тело целиком состоит из одного отрезка файла и может быть отправлено без чтения в память
+        bool IsSingleSegment() const noexcept;
+
+        beast::file& GetFile() noexcept;
+        const Parts& GetParts() const noexcept;
+        const std::string& GetSuffix() const noexcept;
+    private:
+        beast::file file_;
+        std::uint64_t file_size_ = 0;
+        Parts parts_;
+        std::string suffix_;
+    };
+
+    static std::uint64_t size(const value_type& body) {
+        return body.GetSize();
+    }
+
+    class writer {
+    public:
+        using const_buffers_type = net::const_buffer;
+
+        template <bool isRequest, typename Fields>
+        writer([[maybe_unused]] http::header<isRequest, Fields>& header, value_type& body)
+            : body_(body) {
+        }
+
+        void init(beast::error_code& ec) {
+            ec = {};
+        }
+
+        boost::optional<std::pair<const_buffers_type, bool>> get(beast::error_code& ec);
+    private:
+        constexpr static std::size_t BUFFER_SIZE = 16 * 1024;
+
+        value_type& body_;
+        std::size_t part_index_ = 0;
+        bool prefix_sent_ = false;
+        bool suffix_sent_ = false;
+        std::uint64_t part_pos_ = 0;
+        std::array<char, BUFFER_SIZE> buffer_;
+    };
+};
+
+//Заголовки и разбиение тела ответа 206 одинаковы для файлов из кэша и с диска
+struct PartialContent {
+    std::string content_type;
+    //Только для ответа с одним диапазоном, у multipart-ответа диапазоны указываются в частях
+    std::optional<std::string> content_range;
+    FileRangeBody::Parts parts;
+    std::string suffix;
+};
+
+PartialContent MakePartialContent(const Ranges& ranges, std::string_view content_type, std::uint64_t size);
+//Собирает тело ответа 206 из содержимого, уже находящегося в памяти
+std::string AssembleBody(const PartialContent& partial, std::string_view content);
+
+//Значение Content-Range ответа 416
+std::string MakeUnsatisfiedContentRange(std::uint64_t size);
+}//namespace http_range
\ No newline at end of file
@@ -1,16 +1,22 @@
 
 #include <boost/asio/dispatch.hpp>
 
+#include <algorithm>
+#include <cerrno>
+
 #include "http_server.h"
 
+#if HTTP_SERVER_USE_SENDFILE
+#include <sys/sendfile.h>
+#endif
+
 namespace http_server {
 void ReportError(beast::error_code ec, std::string_view what) {
     logger::LogExecution(json_constructor::MakeLogErrorJSON(ec.value(), ec.message(), std::string(what)), "error"sv);
 }
 
 void ReportRequest(const tcp::endpoint& endpoint, std::string_view uri, std::string_view method) {
-    logger::LogExecution(json_constructor::MakeLogRequestJSON(endpoint.address().to_string(), std::string(uri), 
-                                                              std::string(method)), "request received"sv);
+    logger::LogRequest(endpoint.address().to_string(), uri, method);
 }
 
 void SessionBase::Run() {
@@ -68,4 +74,90 @@ void SessionBase::OnWrite(bool close, beast::error_code ec, std::size_t bytes_wr
     // Считываем следующий запрос
     Read();
 }
+
+#if HTTP_SERVER_USE_SENDFILE
+//Ограничение одного вызова sendfile, чтобы одна передача не занимала поток надолго
+const static std::size_t MAX_SENDFILE_CHUNK = 1024 * 1024;
+
+struct SessionBase::SendFileState {
+    explicit SendFileState(http::response<http_range::FileRangeBody>&& res)
+        : response(std::move(res))
+        , serializer(response) {
+    }
+
+    http::response<http_range::FileRangeBody> response;
+    http::response_serializer<http_range::FileRangeBody> serializer;
+    off_t offset = 0;
+    off_t start_offset = 0;
+    std::uint64_t remaining = 0;
+    std::size_t bytes_written = 0;
+};
+
+void SessionBase::WriteFile(http::response<http_range::FileRangeBody>&& response) {
+    auto state = std::make_shared<SendFileState>(std::move(response));
+    const auto& segment = state->response.body().GetParts().front();
+    state->offset = static_cast<off_t>(segment.offset);
+    state->start_offset = state->offset;
+    state->remaining = segment.length;
+
+    http::async_write_header(stream_, state->serializer, 
+                             [state, self = GetSharedThis()](beast::error_code ec, std::size_t bytes_written) {
+                                 if(ec) {
+                                     return self->OnWrite(state->response.need_eof(), ec, bytes_written);
+                                 }
+
+                                 state->bytes_written = bytes_written;
+                                 self->SendFileBody(state);
+                             });
+}
+
+void SessionBase::SendFileBody(std::shared_ptr<SendFileState> state) {
+    auto& socket = stream_.socket();
+    const int file_fd = state->response.body().GetFile().native_handle();
+
+    beast::error_code ec;
+    socket.native_non_blocking(true, ec);
+
+    while(!ec && state->remaining > 0) {
+        const auto chunk = static_cast<std::size_t>(std::min<std::uint64_t>(state->remaining, MAX_SENDFILE_CHUNK));
+        const ssize_t sent = ::sendfile(socket.native_handle(), file_fd, &state->offset, chunk);
+
+        if(sent > 0) {
+            state->remaining -= static_cast<std::uint64_t>(sent);
+            state->bytes_written += static_cast<std::size_t>(sent);
+            continue;
+        }
+
+        if(sent < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if(sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Буфер сокета заполнен: продолжим, когда в него снова можно будет писать
+            socket.async_wait(tcp::socket::wait_write, [state, self = GetSharedThis()](beast::error_code ec) {
+                if(ec) {
+                    return self->OnWrite(state->response.need_eof(), ec, state->bytes_written);
+                }
+
+                self->SendFileBody(state);
+            });
+            return;
+        }
+
+        if(sent < 0 && (errno == EINVAL || errno == ENOSYS) && state->offset == state->start_offset) {
+            // Файл не поддерживает sendfile: тело записывается обычным способом тем же сериализатором
+            http::async_write(stream_, state->serializer, 
+                              [state, self = GetSharedThis()](beast::error_code ec, std::size_t bytes_written) {
+                                  self->OnWrite(state->response.need_eof(), ec, state->bytes_written + bytes_written);
+                              });
+            return;
+        }
+
+        // Нулевой результат означает, что файл оказался короче заявленного размера
+        ec = sent == 0 ? beast::error_code(net::error::eof) : beast::error_code(errno, sys::system_category());
+    }
+
+    OnWrite(state->response.need_eof(), ec, state->bytes_written);
+}
+#endif
 } // namespace http_server
\ No newline at end of file
@@ -9,10 +9,21 @@
 #include <boost/beast/http.hpp>
 #include <boost/system.hpp>
 
+#include <memory>
+#include <type_traits>
+
 #include "../json/json_constructor.h"
 #include "../sdk.h"
+#include "http_range.h"
 #include "logger.h"
 
+//Передача файлов через sendfile доступна только на Linux с POSIX-реализацией файлов Beast
+#if defined(__linux__) && BOOST_BEAST_USE_POSIX_FILE
+#define HTTP_SERVER_USE_SENDFILE 1
+#else
+#define HTTP_SERVER_USE_SENDFILE 0
+#endif
+
 namespace http_server {
 namespace beast = boost::beast;
 namespace http = beast::http;
@@ -43,6 +54,13 @@ protected:
 
     template <typename Body, typename Fields>
     void Write(http::response<Body, Fields>&& response) {
+#if HTTP_SERVER_USE_SENDFILE
+        if constexpr (std::is_same_v<http::response<Body, Fields>, http::response<http_range::FileRangeBody>>) {
+            if(response.body().IsSingleSegment()) {
+                return WriteFile(std::move(response));
+            }
+        }
+#endif
         // Запись выполняется асинхронно, поэтому response перемещаем в область кучи
         auto safe_response = std::make_shared<http::response<Body, Fields>>(std::move(response));
 
@@ -66,6 +84,15 @@ private:
 
     void OnWrite(bool close, beast::error_code ec, [[maybe_unused]] std::size_t bytes_written);
 
+#if HTTP_SERVER_USE_SENDFILE
+    struct SendFileState;
+
+    // Заголовок записывается через Beast, а тело файла передаётся ядром прямо в сокет,
+    // минуя буферы пользовательского пространства
+    void WriteFile(http::response<http_range::FileRangeBody>&& response);
+    void SendFileBody(std::shared_ptr<SendFileState> state);
+#endif
+
     // Обработку запроса делегируем подклассу
     virtual void HandleRequest(HttpRequest&& request) = 0;
     virtual std::shared_ptr<SessionBase> GetSharedThis() = 0;
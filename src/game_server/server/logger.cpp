@@ -1,10 +1,29 @@
+#include <boost/core/null_deleter.hpp>
 #include <boost/json/serialize.hpp>
 #include <boost/log/expressions.hpp> // для выражения, задающего фильтр 
+#include <boost/log/sinks/async_frontend.hpp>
+#include <boost/log/sinks/block_on_overflow.hpp>
+#include <boost/log/sinks/bounded_fifo_queue.hpp>
+#include <boost/log/sinks/drop_on_overflow.hpp>
+#include <boost/log/sinks/text_ostream_backend.hpp>
 #include <boost/log/utility/manipulators/add_value.hpp>
 #include <boost/log/utility/setup/file.hpp>
 #include <boost/log/utility/setup/common_attributes.hpp>
 #include <boost/log/utility/setup/console.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "../json/json_tags.h"
 #include "logger.h"
 
 namespace logger {
@@ -18,12 +37,214 @@ using namespace std::literals;
 
 BOOST_LOG_ATTRIBUTE_KEYWORD(timestamp, "TimeStamp", boost::posix_time::ptime)
 BOOST_LOG_ATTRIBUTE_KEYWORD(json_data, "JsonData", boost::json::object);
+//Сообщение записи уже содержит готовую строку JSON
+BOOST_LOG_ATTRIBUTE_KEYWORD(preformatted, "Preformatted", bool);
 
 const static std::string TIMESTAMP = "timestamp"s;
 const static std::string DATA = "data"s;
 const static std::string MESSAGE = "message"s;
+const static std::string_view REQUEST_RECEIVED = "request received"sv;
+const static std::string_view RESPONSE_SENT = "response sent"sv;
+//Начальный размер буфера потока достаточен для записи с длинным URI
+const static std::size_t LINE_RESERVE = 512;
+//Коды ответов начиная с этого считаются ошибками и не отсеиваются выборкой
+const static int FIRST_ERROR_CODE = 400;
+const static int NO_SLOW_THRESHOLD = -1;
+
+//Размер очереди задаётся параметром шаблона Boost.Log, поэтому он фиксирован
+const static std::size_t ASYNC_QUEUE_CAPACITY = 8192;
+//Период вывода накопленных записей. Записи выводятся пачкой с одним сбросом буфера
+const static auto ASYNC_FLUSH_PERIOD = 50ms;
+
+namespace {
+template <typename OverflowStrategy>
+using AsyncSink = sinks::asynchronous_sink<sinks::text_ostream_backend, 
+                                           sinks::bounded_fifo_queue<ASYNC_QUEUE_CAPACITY, OverflowStrategy>>;
+
+struct AsyncLog {
+    boost::shared_ptr<sinks::sink> sink;
+    std::jthread feeder;
+};
+
+//Настройки задаются при запуске сервера, поэтому достаточно упорядочения relaxed
+std::atomic<unsigned> response_sample_rate{1};
+std::atomic<int> slow_response_threshold{NO_SLOW_THRESHOLD};
+
+struct LogSinks {
+    std::mutex mutex;
+    boost::shared_ptr<sinks::sink> console;
+    std::optional<AsyncLog> async;
+};
+
+LogSinks& GetSinks() {
+    static LogSinks sinks;
+    return sinks;
+}
+
+//Возвращает асинхронный приёмник и функцию, которая выводит накопленные в нём записи
+template <typename OverflowStrategy>
+std::pair<boost::shared_ptr<sinks::sink>, std::function<void()>> MakeAsyncSink() {
+    auto backend = boost::make_shared<sinks::text_ostream_backend>();
+    backend->add_stream(boost::shared_ptr<std::ostream>(&std::cout, boost::null_deleter()));
+    backend->auto_flush(false);
+
+    //Собственный поток приёмника не запускается: записи забирает поток AsyncLog::feeder
+    auto sink = boost::make_shared<AsyncSink<OverflowStrategy>>(backend, false);
+    sink->set_formatter(&MyFormatter);
+
+    return {sink, [sink, backend] {
+        sink->feed_records();
+        backend->flush();
+    }};
+}
+
+bool ShouldLogResponse(int response_time, int code) {
+    if(code >= FIRST_ERROR_CODE) {
+        return true;
+    }
+
+    const int threshold = slow_response_threshold.load(std::memory_order_relaxed);
+    if(threshold != NO_SLOW_THRESHOLD && response_time >= threshold) {
+        return true;
+    }
+
+    const unsigned rate = response_sample_rate.load(std::memory_order_relaxed);
+    if(rate <= 1) {
+        return true;
+    }
+
+    //Счётчик у каждого потока свой, чтобы потоки не конкурировали за общую переменную
+    thread_local uint64_t responses_count = 0;
+    return responses_count++ % rate == 0;
+}
+
+//Метка времени в формате to_iso_extended_string для местного времени. Дата и время
+//с точностью до секунды форматируются заново только при смене секунды
+void AppendTimestamp(std::string& out) {
+    struct SecondPrefix {
+        std::time_t second = -1;
+        std::array<char, 32> text{};
+        std::size_t size = 0;
+    };
+    thread_local SecondPrefix cache;
+
+    const auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(since_epoch - seconds).count();
+
+    if(const std::time_t second = seconds.count(); second != cache.second) {
+        std::tm local{};
+        localtime_r(&second, &local);
+        cache.size = std::strftime(cache.text.data(), cache.text.size(), "%Y-%m-%dT%H:%M:%S", &local);
+        cache.second = second;
+    }
+    out.append(cache.text.data(), cache.size);
+
+    //Как и boost::posix_time, дробная часть выводится только если она не нулевая
+    if(micros != 0) {
+        std::array<char, 8> digits{'.', '0', '0', '0', '0', '0', '0'};
+        auto value = micros;
+        for(std::size_t i = 6; i > 0; --i, value /= 10) {
+            digits[i] = static_cast<char>('0' + value % 10);
+        }
+        out.append(digits.data(), 7);
+    }
+}
+
+void AppendNumber(std::string& out, int value) {
+    std::array<char, 16> digits;
+    auto [end, ec] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    out.append(digits.data(), end);
+}
+
+//Экранирует строку так же, как boost::json::serialize
+void AppendEscaped(std::string& out, std::string_view value) {
+    constexpr static std::string_view HEX = "0123456789abcdef";
+
+    out += '"';
+    for(char c : value) {
+        switch(c) {
+            case '"': out += "\\\""sv; break;
+            case '\\': out += "\\\\"sv; break;
+            case '\b': out += "\\b"sv; break;
+            case '\f': out += "\\f"sv; break;
+            case '\n': out += "\\n"sv; break;
+            case '\r': out += "\\r"sv; break;
+            case '\t': out += "\\t"sv; break;
+            default: {
+                if(static_cast<unsigned char>(c) < 0x20) {
+                    out += "\\u00"sv;
+                    out += HEX[static_cast<unsigned char>(c) >> 4];
+                    out += HEX[static_cast<unsigned char>(c) & 0xf];
+                } else {
+                    out += c;
+                }
+            }
+        }
+    }
+    out += '"';
+}
+
+void AppendKey(std::string& out, std::string_view key) {
+    out += '"';
+    out += key;
+    out += "\":"sv;
+}
+
+//Начинает запись в буфере потока: {"timestamp":"...","data":{
+std::string& BeginLine() {
+    thread_local std::string line = [] {
+        std::string result;
+        result.reserve(LINE_RESERVE);
+        return result;
+    }();
+
+    line.clear();
+    line += '{';
+    AppendKey(line, TIMESTAMP);
+    line += '"';
+    AppendTimestamp(line);
+    line += "\","sv;
+    AppendKey(line, DATA);
+    line += '{';
+
+    return line;
+}
+
+//Завершает запись: },"message":"..."} и передаёт её в Boost.Log
+void EndLine(std::string& line, std::string_view message) {
+    line += "},"sv;
+    AppendKey(line, MESSAGE);
+    AppendEscaped(line, message);
+    line += '}';
+
+    BOOST_LOG_TRIVIAL(info) << log::add_value(preformatted, true) << line;
+}
+
+void RunFeeder(std::stop_token stop, const std::function<void()>& feed) {
+    std::mutex mutex;
+    std::condition_variable_any cv;
+
+    while(!stop.stop_requested()) {
+        feed();
+
+        std::unique_lock lock(mutex);
+        cv.wait_for(lock, stop, ASYNC_FLUSH_PERIOD, [] {
+            return false;
+        });
+    }
+
+    //Записи, поставленные в очередь до остановки, выводятся полностью
+    feed();
+}
+}// namespace
 
 void MyFormatter(log::record_view const &rec, log::formatting_ostream &strm) {
+    if(rec[preformatted]) {
+        strm << *rec[expr::smessage];
+        return;
+    }
+
     boost::json::object val;
     
     val[TIMESTAMP] = to_iso_extended_string(*rec[timestamp]);
@@ -36,14 +257,91 @@ void MyFormatter(log::record_view const &rec, log::formatting_ostream &strm) {
 void InitBoostLogFilter() {
     log::add_common_attributes();
 
-    log::add_console_log(
+    GetSinks().console = log::add_console_log(
         std::cout,
         keywords::auto_flush = true,
         keywords::format = &MyFormatter
     );
 }
 
+void StartAsyncLog(OverflowPolicy policy) {
+    auto& log_sinks = GetSinks();
+    std::lock_guard lock(log_sinks.mutex);
+
+    if(log_sinks.async) {
+        return;
+    }
+
+    auto [sink, feed] = policy == OverflowPolicy::DROP ? MakeAsyncSink<sinks::drop_on_overflow>()
+                                                       : MakeAsyncSink<sinks::block_on_overflow>();
+
+    auto core = log::core::get();
+    core->add_sink(sink);
+    if(log_sinks.console) {
+        core->remove_sink(log_sinks.console);
+    }
+
+    log_sinks.async = AsyncLog{std::move(sink), std::jthread(RunFeeder, std::move(feed))};
+}
+
+void StopAsyncLog() {
+    auto& log_sinks = GetSinks();
+    std::lock_guard lock(log_sinks.mutex);
+
+    if(!log_sinks.async) {
+        return;
+    }
+
+    auto core = log::core::get();
+    if(log_sinks.console) {
+        core->add_sink(log_sinks.console);
+    }
+    core->remove_sink(log_sinks.async->sink);
+
+    //jthread запрашивает остановку и дожидается вывода оставшихся записей
+    log_sinks.async.reset();
+}
+
 void LogExecution(const boost::json::object& val, std::string_view message) {
     BOOST_LOG_TRIVIAL(info) << log::add_value(json_data, val) << message;
 }
+
+void LogRequest(std::string_view ip, std::string_view uri, std::string_view method) {
+    auto& line = BeginLine();
+
+    AppendKey(line, json_tag::IP);
+    AppendEscaped(line, ip);
+    line += ',';
+    AppendKey(line, json_tag::URI);
+    AppendEscaped(line, uri);
+    line += ',';
+    AppendKey(line, json_tag::METHOD);
+    AppendEscaped(line, method);
+
+    EndLine(line, REQUEST_RECEIVED);
+}
+
+void LogResponse(int response_time, int code, std::string_view content_type) {
+    if(!ShouldLogResponse(response_time, code)) {
+        return;
+    }
+
+    auto& line = BeginLine();
+
+    AppendKey(line, json_tag::RESPONSE_TIME);
+    AppendNumber(line, response_time);
+    line += ',';
+    AppendKey(line, json_tag::CODE);
+    AppendNumber(line, code);
+    line += ',';
+    AppendKey(line, json_tag::CONTENT_TYPE);
+    AppendEscaped(line, content_type);
+
+    EndLine(line, RESPONSE_SENT);
+}
+
+void SetResponseSampling(unsigned every_nth, std::optional<int> slow_threshold) {
+    response_sample_rate.store(std::max(1u, every_nth), std::memory_order_relaxed);
+    slow_response_threshold.store(slow_threshold.value_or(NO_SLOW_THRESHOLD), std::memory_order_relaxed);
+}
 }//namespace logger
\ No newline at end of file
@@ -12,8 +12,31 @@
 namespace logger {
 namespace log = boost::log;
 
+//Поведение асинхронного журнала при переполнении очереди записей
+enum class OverflowPolicy {
+    //Новые записи отбрасываются, потоки обработки запросов никогда не ждут вывода
+    DROP,
+    //Записывающий поток ждёт, пока в очереди освободится место
+    BLOCK
+};
+
 void MyFormatter(log::record_view const& rec, log::formatting_ostream& strm);
 void InitBoostLogFilter();
 
+//Заменяет синхронный вывод в консоль на асинхронный: записи помещаются в ограниченную очередь
+//и выводятся пачками отдельным потоком без сброса буфера после каждой строки
+void StartAsyncLog(OverflowPolicy policy);
+//Выводит оставшиеся в очереди записи и возвращает синхронный вывод. Без асинхронного журнала ничего не делает
+void StopAsyncLog();
+
 void LogExecution(const boost::json::object& val, std::string_view message);
+//Записи о запросах и ответах имеют фиксированную схему, поэтому строка JSON формируется сразу
+//в буфере потока без построения boost::json::object
+void LogRequest(std::string_view ip, std::string_view uri, std::string_view method);
+//Успешные ответы записываются выборочно согласно SetResponseSampling
+void LogResponse(int response_time, int code, std::string_view content_type);
+
+//Записывается каждый every_nth успешный ответ. Ответы с ошибкой и ответы не быстрее
+//slow_threshold миллисекунд записываются всегда
+void SetResponseSampling(unsigned every_nth, std::optional<int> slow_threshold = std::nullopt);
 }//namespace logger
\ No newline at end of file
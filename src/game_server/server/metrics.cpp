@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "metrics.h"
+
+namespace metrics {
+using namespace std::literals;
+using targets_storage::TargetRequestType;
+
+const static std::vector<double> DURATION_BOUNDS{0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+                                                 0.025, 0.05, 0.1, 0.25, 0.5, 1., 2.5, 5.};
+const static std::vector<double> GATHER_EVENTS_BOUNDS{0., 1., 2., 5., 10., 20., 50., 100.};
+
+const static std::string_view PREFIX = "game_server_"sv;
+const static std::string_view TYPE_LABEL = "type"sv;
+const static std::string_view MAP_LABEL = "map"sv;
+const static std::string_view PHASE_LABEL = "phase"sv;
+
+namespace {
+size_t GetShardIndex() {
+    static std::atomic<size_t> next_index{0};
+    thread_local const size_t index = next_index.fetch_add(1, std::memory_order_relaxed) % SHARDS_COUNT;
+
+    return index;
+}
+
+void AppendNumber(std::string& out, double value) {
+    if(std::isinf(value)) {
+        out += value > 0 ? "+Inf"sv : "-Inf"sv;
+        return;
+    }
+
+    std::array<char, 32> digits;
+    auto [end, ec] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    out.append(digits.data(), end);
+}
+
+void AppendNumber(std::string& out, uint64_t value) {
+    std::array<char, 24> digits;
+    auto [end, ec] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    out.append(digits.data(), end);
+}
+
+//Значение метки экранируется по правилам текстового формата Prometheus
+void AppendLabelValue(std::string& out, std::string_view value) {
+    out += '"';
+    for(char c : value) {
+        switch(c) {
+            case '\\': out += "\\\\"sv; break;
+            case '"': out += "\\\""sv; break;
+            case '\n': out += "\\n"sv; break;
+            default: out += c;
+        }
+    }
+    out += '"';
+}
+
+//Метки в виде {name="value"} без закрывающей скобки, чтобы к ним можно было добавить le
+std::string MakeLabels(std::string_view name, std::string_view value) {
+    std::string result = "{";
+    result += name;
+    result += '=';
+    AppendLabelValue(result, value);
+
+    return result;
+}
+
+void AppendHeader(std::string& out, std::string_view name, std::string_view type, std::string_view help) {
+    out.append("# HELP "sv).append(PREFIX).append(name).append(" "sv).append(help).append("\n"sv);
+    out.append("# TYPE "sv).append(PREFIX).append(name).append(" "sv).append(type).append("\n"sv);
+}
+
+//labels — пустая строка либо незакрытый список меток из MakeLabels
+void AppendHistogram(std::string& out, std::string_view name, const std::string& labels, const Histogram& histogram) {
+    const auto snapshot = histogram.Collect();
+    const auto& bounds = histogram.GetBounds();
+
+    for(size_t i = 0; i < snapshot.buckets.size(); ++i) {
+        out.append(PREFIX).append(name).append("_bucket"sv);
+        out += labels.empty() ? "{"s : labels + ',';
+        out += "le=\""sv;
+        AppendNumber(out, i < bounds.size() ? bounds[i] : std::numeric_limits<double>::infinity());
+        out += "\"} "sv;
+        AppendNumber(out, snapshot.buckets[i]);
+        out += '\n';
+    }
+
+    const std::string closed_labels = labels.empty() ? ""s : labels + '}';
+
+    out.append(PREFIX).append(name).append("_sum"sv).append(closed_labels).append(" "sv);
+    AppendNumber(out, snapshot.sum);
+    out += '\n';
+
+    out.append(PREFIX).append(name).append("_count"sv).append(closed_labels).append(" "sv);
+    AppendNumber(out, snapshot.count);
+    out += '\n';
+}
+
+void AppendCounter(std::string& out, std::string_view name, const Counter& counter) {
+    out.append(PREFIX).append(name).append(" "sv);
+    AppendNumber(out, counter.GetValue());
+    out += '\n';
+}
+
+void AppendGauge(std::string& out, std::string_view name, const std::string& labels, const Gauge& gauge) {
+    out.append(PREFIX).append(name).append(labels).append(labels.empty() ? ""sv : "}"sv).append(" "sv);
+    AppendNumber(out, gauge.GetValue());
+    out += '\n';
+}
+}// namespace
+
+//_________Gauge_________
+void Gauge::Set(double value) noexcept {
+    value_.store(value, std::memory_order_relaxed);
+}
+
+double Gauge::GetValue() const noexcept {
+    return value_.load(std::memory_order_relaxed);
+}
+
+//_________Counter_________
+void Counter::Add(uint64_t value) noexcept {
+    value_.fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t Counter::GetValue() const noexcept {
+    return value_.load(std::memory_order_relaxed);
+}
+
+//_________Histogram_________
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds)) {
+    if(bounds_.size() + 1 > MAX_BUCKETS_COUNT) {
+        throw std::invalid_argument("Too many histogram buckets"s);
+    }
+
+    for(auto& shard : shards_) {
+        shard = std::make_unique<Shard>();
+    }
+}
+
+void Histogram::Observe(double value) noexcept {
+    //Корзина le включает значения, не превышающие границу
+    const size_t bucket = std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin();
+    auto& shard = *shards_[GetShardIndex()];
+
+    shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+void Histogram::ObserveDuration(Clock::duration duration) noexcept {
+    Observe(std::chrono::duration<double>(duration).count());
+}
+
+Histogram::Snapshot Histogram::Collect() const {
+    Snapshot result;
+    result.buckets.resize(bounds_.size() + 1);
+
+    for(const auto& shard : shards_) {
+        for(size_t i = 0; i < result.buckets.size(); ++i) {
+            result.buckets[i] += shard->buckets[i].load(std::memory_order_relaxed);
+        }
+        result.sum += shard->sum.load(std::memory_order_relaxed);
+    }
+
+    for(size_t i = 1; i < result.buckets.size(); ++i) {
+        result.buckets[i] += result.buckets[i - 1];
+    }
+    result.count = result.buckets.back();
+
+    return result;
+}
+
+const std::vector<double>& Histogram::GetBounds() const noexcept {
+    return bounds_;
+}
+
+//_________SessionMetrics_________
+SessionMetrics::SessionMetrics()
+    : tick_duration(DURATION_BOUNDS)
+    , gather_events(GATHER_EVENTS_BOUNDS) {
+}
+
+//_________ServerMetrics_________
+ServerMetrics::ServerMetrics()
+    : db_write_duration_(DURATION_BOUNDS)
+    , connection_wait_duration_(DURATION_BOUNDS)
+    , save_state_duration_(DURATION_BOUNDS) {
+    request_duration_.reserve(REQUEST_TYPES_COUNT);
+    for(size_t i = 0; i < REQUEST_TYPES_COUNT; ++i) {
+        request_duration_.emplace_back(DURATION_BOUNDS);
+    }
+
+    tick_phase_duration_.reserve(tick_profiler::PHASES_COUNT);
+    for(size_t i = 0; i < tick_profiler::PHASES_COUNT; ++i) {
+        tick_phase_duration_.emplace_back(DURATION_BOUNDS);
+    }
+}
+
+void ServerMetrics::ObserveRequest(TargetRequestType req_type, Clock::duration duration) noexcept {
+    request_duration_[static_cast<size_t>(req_type)].ObserveDuration(duration);
+}
+
+void ServerMetrics::ObserveDbWrite(Clock::duration duration) noexcept {
+    db_write_duration_.ObserveDuration(duration);
+}
+
+void ServerMetrics::ObserveConnectionWait(Clock::duration duration) noexcept {
+    connection_wait_duration_.ObserveDuration(duration);
+}
+
+void ServerMetrics::ObserveSaveState(Clock::duration duration) noexcept {
+    save_state_duration_.ObserveDuration(duration);
+}
+
+void ServerMetrics::AddTickOverruns(uint64_t overruns) noexcept {
+    tick_overruns_.Add(overruns);
+}
+
+void ServerMetrics::ObserveTickPhases(const tick_profiler::PhasesDuration& phases) noexcept {
+    for(size_t i = 0; i < phases.size(); ++i) {
+        tick_phase_duration_[i].ObserveDuration(phases[i]);
+    }
+}
+
+SessionMetrics& ServerMetrics::AddSession(const std::string& map_id) {
+    std::lock_guard lock(sessions_mutex_);
+
+    auto& session = sessions_[map_id];
+    if(!session) {
+        session = std::make_unique<SessionMetrics>();
+    }
+
+    return *session;
+}
+
+std::string ServerMetrics::Render() const {
+    std::string result;
+
+    AppendHeader(result, "request_duration_seconds"sv, "histogram"sv, "Request processing time by request type"sv);
+    for(size_t i = 0; i < REQUEST_TYPES_COUNT; ++i) {
+        AppendHistogram(result, "request_duration_seconds"sv,
+                        MakeLabels(TYPE_LABEL, ToLabel(static_cast<TargetRequestType>(i))), request_duration_[i]);
+    }
+
+    AppendHeader(result, "db_write_duration_seconds"sv, "histogram"sv, "Time of writing retired players to database"sv);
+    AppendHistogram(result, "db_write_duration_seconds"sv, ""s, db_write_duration_);
+
+    AppendHeader(result, "db_connection_wait_seconds"sv, "histogram"sv, "Time of waiting for free database connection"sv);
+    AppendHistogram(result, "db_connection_wait_seconds"sv, ""s, connection_wait_duration_);
+
+    AppendHeader(result, "save_state_duration_seconds"sv, "histogram"sv, "Time of writing game state to file"sv);
+    AppendHistogram(result, "save_state_duration_seconds"sv, ""s, save_state_duration_);
+
+    AppendHeader(result, "tick_phase_duration_seconds"sv, "histogram"sv, "Time of tick phase summed over game sessions"sv);
+    for(size_t i = 0; i < tick_profiler::PHASES_COUNT; ++i) {
+        AppendHistogram(result, "tick_phase_duration_seconds"sv,
+                        MakeLabels(PHASE_LABEL, tick_profiler::ToLabel(static_cast<tick_profiler::Phase>(i))),
+                        tick_phase_duration_[i]);
+    }
+
+    AppendHeader(result, "tick_overruns_total"sv, "counter"sv, "Number of tick deadlines missed by ticker"sv);
+    AppendCounter(result, "tick_overruns_total"sv, tick_overruns_);
+
+    std::lock_guard lock(sessions_mutex_);
+
+    AppendHeader(result, "tick_duration_seconds"sv, "histogram"sv, "Time of processing tick by game session"sv);
+    for(const auto& [map_id, session] : sessions_) {
+        AppendHistogram(result, "tick_duration_seconds"sv, MakeLabels(MAP_LABEL, map_id), session->tick_duration);
+    }
+
+    AppendHeader(result, "gather_events_per_tick"sv, "histogram"sv, "Number of gather events found by game session per tick"sv);
+    for(const auto& [map_id, session] : sessions_) {
+        AppendHistogram(result, "gather_events_per_tick"sv, MakeLabels(MAP_LABEL, map_id), session->gather_events);
+    }
+
+    AppendHeader(result, "session_dogs"sv, "gauge"sv, "Number of dogs in game session"sv);
+    for(const auto& [map_id, session] : sessions_) {
+        AppendGauge(result, "session_dogs"sv, MakeLabels(MAP_LABEL, map_id), session->dogs);
+    }
+
+    AppendHeader(result, "session_lost_objects"sv, "gauge"sv, "Number of lost objects in game session"sv);
+    for(const auto& [map_id, session] : sessions_) {
+        AppendGauge(result, "session_lost_objects"sv, MakeLabels(MAP_LABEL, map_id), session->loot);
+    }
+
+    return result;
+}
+
+ServerMetrics& GetServerMetrics() {
+    static ServerMetrics metrics;
+    return metrics;
+}
+
+std::string_view ToLabel(TargetRequestType req_type) {
+    switch (req_type) {
+        case TargetRequestType::GET_MAPS_INFO : return "get_maps_info"sv;
+        case TargetRequestType::GET_MAP_BY_ID : return "get_map_by_id"sv;
+        case TargetRequestType::GET_FILE : return "get_file"sv;
+        case TargetRequestType::GET_PLAYERS : return "get_players"sv;
+        case TargetRequestType::GET_STATE : return "get_state"sv;
+        case TargetRequestType::GET_RECORDS : return "get_records"sv;
+        case TargetRequestType::GET_METRICS : return "get_metrics"sv;
+        case TargetRequestType::GET_TICK_PROFILE : return "get_tick_profile"sv;
+        case TargetRequestType::POST_JOIN_GAME : return "post_join_game"sv;
+        case TargetRequestType::POST_ACTION : return "post_action"sv;
+        case TargetRequestType::POST_TICK : return "post_tick"sv;
+        case TargetRequestType::ERROR_API : return "error_api"sv;
+        default : return "unknown"sv;
+    }
+}
+}//namespace metrics
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../handlers/target_storage.h"
+#include "tick_profiler.h"
+
+namespace metrics {
+using Clock = std::chrono::steady_clock;
+
+//Каждый поток обновляет свою ячейку, поэтому одновременные обновления из разных потоков
+//не конкурируют за одну кэш-линию. Значение метрики складывается из всех ячеек при чтении
+constexpr static std::size_t SHARDS_COUNT = 16;
+constexpr static std::size_t CACHE_LINE_SIZE = 64;
+
+class Gauge {
+public:
+    void Set(double value) noexcept;
+    double GetValue() const noexcept;
+private:
+    std::atomic<double> value_{0.};
+};
+
+class Counter {
+public:
+    void Add(uint64_t value) noexcept;
+    uint64_t GetValue() const noexcept;
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+class Histogram {
+public:
+    //Корзины хранятся в ячейке без отдельного выделения памяти, поэтому их число ограничено
+    constexpr static std::size_t MAX_BUCKETS_COUNT = 23;
+
+    //bounds — верхние границы корзин по возрастанию, корзина +Inf добавляется сама.
+    //Бросает std::invalid_argument, если вместе с ней корзин больше MAX_BUCKETS_COUNT
+    explicit Histogram(std::vector<double> bounds);
+
+    void Observe(double value) noexcept;
+    //Длительность учитывается в секундах, как принято в Prometheus
+    void ObserveDuration(Clock::duration duration) noexcept;
+
+    struct Snapshot {
+        //Накопленные значения: корзина включает все меньшие, последняя соответствует +Inf
+        std::vector<uint64_t> buckets;
+        uint64_t count = 0;
+        double sum = 0.;
+    };
+
+    Snapshot Collect() const;
+    const std::vector<double>& GetBounds() const noexcept;
+private:
+    //Корзины лежат внутри выровненной ячейки, поэтому ячейки разных потоков не делят кэш-линии
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        std::array<std::atomic<uint64_t>, MAX_BUCKETS_COUNT> buckets{};
+        std::atomic<double> sum{0.};
+    };
+
+    std::vector<double> bounds_;
+    std::array<std::unique_ptr<Shard>, SHARDS_COUNT> shards_;
+};
+
+struct SessionMetrics {
+    SessionMetrics();
+
+    Histogram tick_duration;
+    Histogram gather_events;
+    Gauge dogs;
+    Gauge loot;
+};
+
+//Метрики сервера в формате Prometheus. Обновление метрик не захватывает блокировок,
+//мьютекс защищает только набор сессий, который заполняется при запуске сервера
+class ServerMetrics {
+public:
+    ServerMetrics();
+
+    void ObserveRequest(targets_storage::TargetRequestType req_type, Clock::duration duration) noexcept;
+    void ObserveDbWrite(Clock::duration duration) noexcept;
+    void ObserveConnectionWait(Clock::duration duration) noexcept;
+    void ObserveSaveState(Clock::duration duration) noexcept;
+    void ObserveTickPhases(const tick_profiler::PhasesDuration& phases) noexcept;
+    void AddTickOverruns(uint64_t overruns) noexcept;
+
+    //Повторный вызов для той же карты возвращает те же метрики
+    SessionMetrics& AddSession(const std::string& map_id);
+
+    std::string Render() const;
+private:
+    constexpr static size_t REQUEST_TYPES_COUNT = static_cast<size_t>(targets_storage::TargetRequestType::UNKNOW) + 1;
+
+    std::vector<Histogram> request_duration_;
+    Histogram db_write_duration_;
+    Histogram connection_wait_duration_;
+    Histogram save_state_duration_;
+    std::vector<Histogram> tick_phase_duration_;
+    Counter tick_overruns_;
+
+    mutable std::mutex sessions_mutex_;
+    std::map<std::string, std::unique_ptr<SessionMetrics>> sessions_;
+};
+
+//Метрики процесса, общие для всех обработчиков, по аналогии с журналом
+ServerMetrics& GetServerMetrics();
+
+std::string_view ToLabel(targets_storage::TargetRequestType req_type);
+}//namespace metrics
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <algorithm>
+
+#include "tick_profiler.h"
+
+namespace tick_profiler {
+using namespace std::literals;
+
+//_________TickRecord_________
+Phase TickRecord::GetSlowestPhase() const noexcept {
+    return static_cast<Phase>(std::max_element(phases.begin(), phases.end()) - phases.begin());
+}
+
+//_________TickProfiler_________
+TickProfiler::TickProfiler(std::chrono::milliseconds period, std::size_t history_size)
+    : period_(period)
+    , history_size_(std::max<std::size_t>(history_size, 1)) {
+    history_.reserve(history_size_);
+}
+
+const TickRecord& TickProfiler::AddTick(std::chrono::milliseconds delta, Clock::duration duration,
+                                        const PhasesDuration& phases) {
+    TickRecord record{++ticks_count_, delta, duration, phases, period_.count() != 0 && duration > period_};
+    if(record.overrun) {
+        ++overruns_count_;
+    }
+
+    //Новая запись замещает самую старую
+    const std::size_t index = next_index_;
+    next_index_ = (next_index_ + 1) % history_size_;
+
+    if(history_.size() < history_size_) {
+        history_.push_back(record);
+    } else {
+        history_[index] = record;
+    }
+
+    return history_[index];
+}
+
+std::vector<TickRecord> TickProfiler::GetHistory() const {
+    if(history_.size() < history_size_) {
+        return history_;
+    }
+
+    std::vector<TickRecord> result;
+    result.reserve(history_.size());
+    result.insert(result.end(), history_.begin() + next_index_, history_.end());
+    result.insert(result.end(), history_.begin(), history_.begin() + next_index_);
+
+    return result;
+}
+
+std::chrono::milliseconds TickProfiler::GetPeriod() const noexcept {
+    return period_;
+}
+
+std::uint64_t TickProfiler::GetTicksCount() const noexcept {
+    return ticks_count_;
+}
+
+std::uint64_t TickProfiler::GetOverrunsCount() const noexcept {
+    return overruns_count_;
+}
+
+std::string_view ToLabel(Phase phase) {
+    switch (phase) {
+        case Phase::MOVE_UNITS : return "move_units"sv;
+        case Phase::PROCESS_LOOT : return "process_loot"sv;
+        case Phase::GENERATE_LOOT : return "generate_loot"sv;
+        case Phase::PUBLISH_SNAPSHOT : return "publish_snapshot"sv;
+        case Phase::SEND_INTO_RETIREMENT : return "send_into_retirement"sv;
+        case Phase::SET_RECORDS : return "set_records"sv;
+        case Phase::ON_TICK : return "on_tick"sv;
+        default : return "unknown"sv;
+    }
+}
+}//namespace tick_profiler
\ No newline at end of file
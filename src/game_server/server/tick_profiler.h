@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "../model/tick_phases.h"
+
+namespace tick_profiler {
+//Этапы тика измеряются в модели, профилировщик только накапливает их историю
+using Clock = model::TickClock;
+using Phase = model::TickPhase;
+using PhasesDuration = model::TickPhasesDuration;
+
+constexpr static std::size_t PHASES_COUNT = model::TICK_PHASES_COUNT;
+constexpr static std::size_t DEFAULT_HISTORY_SIZE = 256;
+
+struct TickRecord {
+    std::uint64_t number = 0;
+    std::chrono::milliseconds delta{};
+    //Время от начала обработки тика до завершения последнего этапа
+    Clock::duration duration{};
+    //Этапы сессий суммируются по всем сессиям, даже если они обрабатывались параллельно
+    PhasesDuration phases{};
+    bool overrun = false;
+
+    Phase GetSlowestPhase() const noexcept;
+};
+
+//История последних тиков. Используется только в api_strand_, поэтому не синхронизируется
+class TickProfiler {
+public:
+    //Тик превышает период, если обрабатывается дольше него. Нулевой период — тик по запросу,
+    //у него превышений не бывает
+    explicit TickProfiler(std::chrono::milliseconds period, std::size_t history_size = DEFAULT_HISTORY_SIZE);
+
+    const TickRecord& AddTick(std::chrono::milliseconds delta, Clock::duration duration, const PhasesDuration& phases);
+
+    //Записи от старых к новым
+    std::vector<TickRecord> GetHistory() const;
+    std::chrono::milliseconds GetPeriod() const noexcept;
+    std::uint64_t GetTicksCount() const noexcept;
+    std::uint64_t GetOverrunsCount() const noexcept;
+private:
+    std::chrono::milliseconds period_;
+    std::vector<TickRecord> history_;
+    std::size_t history_size_;
+    std::size_t next_index_ = 0;
+    std::uint64_t ticks_count_ = 0;
+    std::uint64_t overruns_count_ = 0;
+};
+
+std::string_view ToLabel(Phase phase);
+}//namespace tick_profiler
\ No newline at end of file
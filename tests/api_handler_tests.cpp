@@ -0,0 +1,174 @@
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/json/parse.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../src/game_server/handlers/api_handler.h"
+#include "../src/game_server/handlers/target_storage.h"
+#include "../src/game_server/json/json_loader.h"
+#include "../src/game_server/server/extra_data.h"
+
+using namespace std::literals;
+using targets_storage::ContentType;
+using targets_storage::TargetRequestType;
+using targets_storage::UsingTargetPath;
+
+namespace {
+//Обработчик без базы данных и файла состояния. Нулевой период — тик только по запросу
+http_handler::ApiHandler MakeApiHandler(net::io_context& ioc, std::chrono::milliseconds period, unsigned tick_threads = 0) {
+    extra_data::LootTypes types;
+    auto game = json_loader::LoadGame("../tests/test_data/config _with_capacity.json"s, types, false);
+
+    http_handler::BuilderApiHandler builder;
+    return builder.SetStrand(net::make_strand(ioc))
+                  .SetGame(std::move(game))
+                  .SetLootTypes(std::move(types))
+                  .SetTimer(std::move(period))
+                  .SetStateFile(""s)
+                  .SetTickThreads(tick_threads)
+                  .Build();
+}
+
+StringRequest MakeRequest(http::verb verb, std::string_view target, std::string body, std::string_view token = ""sv) {
+    StringRequest req{verb, target, 11};
+    req.set(http::field::content_type, ContentType::APPLICATION_JSON);
+    if(!token.empty()) {
+        req.set(http::field::authorization, "Bearer "s + std::string(token));
+    }
+    req.body() = std::move(body);
+    req.prepare_payload();
+
+    return req;
+}
+
+//Возвращает все ответы на один ручной тик
+std::vector<ApiResponse> RunManualTick(unsigned tick_threads) {
+    net::io_context ioc;
+    auto handler = MakeApiHandler(ioc, 0ms, tick_threads);
+    //Сессии могут обрабатываться в пуле потоков, поэтому io_context не должен остановиться до ответа
+    auto work = net::make_work_guard(ioc);
+    std::vector<ApiResponse> responses;
+
+    handler.DispatchApiRequest(MakeRequest(http::verb::post, UsingTargetPath::TICK, R"({"timeDelta": 100})"s),
+                               TargetRequestType::POST_TICK, [&](ApiResponse&& resp) {
+        responses.push_back(std::move(resp));
+        work.reset();
+    });
+    ioc.run();
+
+    //Повторное завершение тика могло бы прийти из пула уже после ответа
+    handler.SaveState();
+    ioc.restart();
+    ioc.run();
+
+    return responses;
+}
+}//namespace
+
+SCENARIO("Routing of player requests", "[Handlers]") {
+    net::io_context ioc;
+    auto handler = MakeApiHandler(ioc, 0ms);
+    auto& session_strand = handler.GetSessionStrand(model::Map::Id("map1"s));
+
+    GIVEN("a player joining the game") {
+        bool join_in_session_strand = false;
+        std::string token;
+        std::string players_body;
+
+        handler.DispatchApiRequest(MakeRequest(http::verb::post, UsingTargetPath::JOIN,
+                                               R"({"userName": "Scooby Doo", "mapId": "map1"})"s),
+                                   TargetRequestType::POST_JOIN_GAME, [&](ApiResponse&& resp) {
+            join_in_session_strand = session_strand.running_in_this_thread();
+            token = boost::json::parse(*resp.body()).as_object().at("authToken").as_string().c_str();
+
+            //Клиент может запросить игроков сразу после ответа, не дожидаясь тика
+            handler.DispatchApiRequest(MakeRequest(http::verb::get, UsingTargetPath::PLAYERS, ""s, token),
+                                       TargetRequestType::GET_PLAYERS, [&](ApiResponse&& players) {
+                players_body = *players.body();
+            });
+        });
+        ioc.run();
+
+        REQUIRE(join_in_session_strand);
+        REQUIRE_FALSE(token.empty());
+
+        THEN("players requested right after the answer contain the new player") {
+            CHECK(players_body.find("Scooby Doo"sv) != std::string::npos);
+        }
+
+        WHEN("player sends an action") {
+            bool action_in_session_strand = false;
+            http::status status{};
+            std::string state_body;
+
+            handler.DispatchApiRequest(MakeRequest(http::verb::post, UsingTargetPath::ACTION, R"({"move": "R"})"s, token),
+                                       TargetRequestType::POST_ACTION, [&](ApiResponse&& resp) {
+                action_in_session_strand = session_strand.running_in_this_thread();
+                status = resp.result();
+
+                handler.DispatchApiRequest(MakeRequest(http::verb::get, UsingTargetPath::STATE, ""s, token),
+                                           TargetRequestType::GET_STATE, [&](ApiResponse&& state) {
+                    state_body = *state.body();
+                });
+            });
+            ioc.restart();
+            ioc.run();
+
+            THEN("it is handled in the session strand") {
+                CHECK(action_in_session_strand);
+                CHECK(status == http::status::ok);
+            }
+
+            AND_THEN("state requested right after the answer contains the action") {
+                CHECK(state_body.find(R"("dir":"R")"sv) != std::string::npos);
+            }
+        }
+    }
+}
+
+SCENARIO("Manual tick", "[Handlers]") {
+    GIVEN("sessions handled in threads of io_context") {
+        auto responses = RunManualTick(0);
+
+        THEN("tick is answered exactly once") {
+            REQUIRE(responses.size() == 1);
+            CHECK(responses.front().result() == http::status::ok);
+        }
+    }
+
+    GIVEN("sessions handled in a separate thread pool") {
+        auto responses = RunManualTick(2);
+
+        THEN("tick is answered exactly once") {
+            REQUIRE(responses.size() == 1);
+            CHECK(responses.front().result() == http::status::ok);
+        }
+    }
+
+    GIVEN("handler with automatic tick") {
+        net::io_context ioc;
+        auto handler = MakeApiHandler(ioc, 50ms);
+        handler.Start(0ms);
+
+        WHEN("manual tick is requested") {
+            http::status status{};
+
+            handler.DispatchApiRequest(MakeRequest(http::verb::post, UsingTargetPath::TICK, R"({"timeDelta": 100})"s),
+                                       TargetRequestType::POST_TICK, [&](ApiResponse&& resp) {
+                status = resp.result();
+                ioc.stop();
+            });
+            //Таймер тика не даёт io_context завершиться самому
+            ioc.run_for(5s);
+
+            THEN("it is rejected") {
+                CHECK(status == http::status::bad_request);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <string>
+
+#include "../src/game_server/app/application.h"
+#include "../src/game_server/app/map_responses.h"
+#include "../src/game_server/app/player_properties.h"
+#include "../src/game_server/handlers/target_storage.h"
+#include "../src/game_server/json/json_constructor.h"
+#include "../src/game_server/json/json_loader.h"
+#include "../src/game_server/server/extra_data.h"
+
+using namespace std::literals;
+
+SCENARIO("Retirement of players by session", "[App]") {
+    app::Application application;
+    extra_data::LootTypes types;
+    application.SetGame(json_loader::LoadGame("../tests/test_data/config _with_capacity.json"s, types, true));
+    application.JoinGame("{\"userName\": \"Scooby Doo\", \"mapId\": \"map1\"}"s);
+    application.JoinGame("{\"userName\": \"Scrappy Doo\", \"mapId\": \"map1\"}"s);
+    application.JoinGame("{\"userName\": \"Shaggy\", \"mapId\": \"town\"}"s);
+
+    const auto& sessions = application.GetSessions();
+    auto map1_session = *std::find_if(sessions.begin(), sessions.end(), [](const auto& session) {
+        return *session->GetMapId() == "map1"s;
+    });
+
+    GIVEN("inactive players on different maps") {
+        WHEN("tick of one session exceeds retirement time") {
+            const auto version = map1_session->GetSnapshot()->version;
+            auto records = application.ProcessSessionTick(*map1_session, application.GetRetirementTime());
+
+            THEN("only players of this session are retired") {
+                CHECK(records.size() == 2);
+                CHECK(map1_session->GetDogs().size() == 0);
+                CHECK(application.GetPlayersData(map1_session->GetMapId()).empty());
+                CHECK(application.GetPlayersData().size() == 1);
+            }
+
+            AND_THEN("one snapshot without retired dogs is published") {
+                CHECK(map1_session->GetSnapshot()->dogs.empty());
+                CHECK(map1_session->GetSnapshot()->version == version + 1);
+            }
+
+            AND_WHEN("tick is repeated") {
+                THEN("nobody is retired twice") {
+                    CHECK(application.ProcessSessionTick(*map1_session, application.GetRetirementTime()).empty());
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Prepared map responses", "[App]") {
+    using targets_storage::TargetRequestType;
+
+    extra_data::LootTypes types;
+    auto game = json_loader::LoadGame("../tests/test_data/config _with_capacity.json"s, types, true);
+    const model::Map::Id map_id("map1"s);
+
+    GIVEN("responses prepared at startup") {
+        app::MapResponses responses(game, types);
+
+        THEN("bodies are equal to built on request") {
+            CHECK(*responses.GetMapsInfo().body == json_constructor::MakeBodyJSON(TargetRequestType::GET_MAPS_INFO, game));
+
+            const auto* map = responses.FindMap(map_id);
+            REQUIRE(map);
+            CHECK(*map->body == json_constructor::MakeBodyJSON(TargetRequestType::GET_MAP_BY_ID, game, 
+                                                               *map_id, types.GetTypes(map_id)));
+        }
+
+        THEN("etags are quoted and depend only on body") {
+            const auto* map = responses.FindMap(map_id);
+            const auto* other_map = responses.FindMap(model::Map::Id("town"s));
+            REQUIRE(map);
+            REQUIRE(other_map);
+
+            CHECK(map->etag.front() == '"');
+            CHECK(map->etag.back() == '"');
+            CHECK(map->etag != other_map->etag);
+            CHECK(app::MapResponses(game, types).FindMap(map_id)->etag == map->etag);
+        }
+
+        THEN("unknown map is not found") {
+            CHECK_FALSE(responses.FindMap(model::Map::Id("unknown"s)));
+        }
+    }
+}
\ No newline at end of file
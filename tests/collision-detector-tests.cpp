@@ -1,6 +1,7 @@
 #define _USE_MATH_DEFINES
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <catch2/matchers/catch_matchers_predicate.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
@@ -13,6 +14,7 @@
 #include <vector>
 #include <cmath>
 #include <functional>
+#include <random>
 
 #include "../src/game_server/model/detail/collision_detector.h"
 
@@ -93,6 +95,8 @@ const static double gatherer_width = 0.6;
 const static double item_width = 0.0;
 
 SCENARIO("No collision detected") {
+    //Все проверки выполняются как для поэлементного, так и для векторного вычисления
+    const auto kernel = GENERATE(CollectKernel::SCALAR, CollectKernel::SIMD);
     double gatherer_width = 0.6;
     double item_width = 0.0;
 
@@ -101,7 +105,7 @@ SCENARIO("No collision detected") {
             {}, {{{5.2, 2.1}, {7.8, 1.2}, gatherer_width}, {{0.7, 0.8}, {10, 10}, gatherer_width}, {{-5, 0}, {10, 5}, gatherer_width}}};
 
         THEN("no events") {
-            auto events = FindGatherEvents(provider);
+            auto events = FindGatherEvents(provider, DetectionMode::SPATIAL_GRID, kernel);
             CHECK(events.empty());
         }
     }
@@ -111,7 +115,7 @@ SCENARIO("No collision detected") {
             {{{1.1, 0.1}, item_width}, {{5.8, 6.2}, item_width}, {{8.1, 4.6}, item_width}}, {}};
         
         THEN("no events"){
-            auto events = FindGatherEvents(provider);
+            auto events = FindGatherEvents(provider, DetectionMode::SPATIAL_GRID, kernel);
             CHECK(events.empty());
         }
     }
@@ -122,7 +126,7 @@ SCENARIO("No collision detected") {
             {{{5.9, 2.1}, {7.8, 1.2}, gatherer_width}, {{4.2, 8.1}, {10.9, 11.2}, gatherer_width}}};
         
         THEN("no events"){
-            auto events = FindGatherEvents(provider);
+            auto events = FindGatherEvents(provider, DetectionMode::SPATIAL_GRID, kernel);
             CHECK(events.empty());
         }
     }
@@ -133,13 +137,15 @@ SCENARIO("No collision detected") {
             {{{1.1, 0.1}, {1.1, 0.1}, gatherer_width}, {{5.8, 6.2}, {5.8, 6.2}, gatherer_width}}};
  
         THEN("no events") {
-            auto events = FindGatherEvents(provider);
+            auto events = FindGatherEvents(provider, DetectionMode::SPATIAL_GRID, kernel);
             CHECK(events.empty());
         }
     }
 }
 
 SCENARIO("Collision detected") {
+    const auto kernel = GENERATE(CollectKernel::SCALAR, CollectKernel::SIMD);
+
     WHEN("multiple items on a way of gatherer") {
         TestItemGathererProvader provider {
             {{{0.0, 0.0}, item_width}/*event*/, {{1.0, 0.06}, item_width}/*event*/, {{2.0, 0.25}, item_width}/*event*/,
@@ -148,7 +154,7 @@ SCENARIO("Collision detected") {
             {{{0.0, 0.0}, {10.0, 0.0}, gatherer_width}}};
 
         THEN("gathered items in right order") {
-            auto events = collision_detector::FindGatherEvents(provider);
+            auto events = collision_detector::FindGatherEvents(provider, DetectionMode::SPATIAL_GRID, kernel);
             EventsCollisionMatcher matcher(std::move(events));
             CHECK(matcher.match(std::vector{
                                 collision_detector::GatheringEvent{0, 0, 0.0 * 0.0,     0.0},
@@ -171,9 +177,124 @@ SCENARIO("Collision detected") {
              {{-2.0, 0.0}, {3.0, 0.0}, gatherer_width}}};
 
         THEN("item gathered by faster gatherer") {
-            auto events = collision_detector::FindGatherEvents(provider);
+            auto events = collision_detector::FindGatherEvents(provider, DetectionMode::SPATIAL_GRID, kernel);
         CHECK(events.front().gatherer_id == 3);
         }
     }
 }
+SCENARIO("Spatial grid detection matches brute force") {
+    const auto kernel = GENERATE(CollectKernel::SCALAR, CollectKernel::SIMD);
+
+    GIVEN("many gatherers and items scattered over the map") {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> coord(-20.0, 20.0);
+        std::uniform_real_distribution<double> step(-3.0, 3.0);
+
+        std::vector<collision_detector::Item> items;
+        for (int i = 0; i < 300; ++i) {
+            items.push_back({{coord(generator), coord(generator)}, i % 3 == 0 ? 0.3 : item_width});
+        }
+
+        std::vector<collision_detector::Gatherer> gatherers;
+        for (int i = 0; i < 100; ++i) {
+            geom::Point2D start{coord(generator), coord(generator)};
+            geom::Point2D end = i % 10 == 0 ? start : geom::Point2D{start.x + step(generator), start.y + step(generator)};
+            gatherers.push_back({start, end, gatherer_width / 2.});
+        }
+        //Собиратель, проходящий через всю карту
+        gatherers.push_back({{-25.0, 0.1}, {25.0, -0.1}, gatherer_width / 2.});
+
+        TestItemGathererProvader provider{items, gatherers};
+
+        WHEN("events are searched with both modes") {
+            auto reference = FindGatherEvents(provider, DetectionMode::BRUTE_FORCE, CollectKernel::SCALAR);
+            auto events = FindGatherEvents(provider, DetectionMode::SPATIAL_GRID, kernel);
+
+            THEN("the same events are found in the same order") {
+                CHECK_FALSE(reference.empty());
+                CHECK(std::equal(reference.begin(), reference.end(), events.begin(), events.end(), are_equal_events));
+            }
+        }
+    }
+}
+
+SCENARIO("Span based detection matches provider based detection") {
+    GIVEN("items and gatherers stored in arrays") {
+        std::vector<collision_detector::Item> items{{{0.0, 0.0}, item_width}, {{1.0, 0.06}, item_width},
+                                                    {{6.0, 0.62}, item_width}, {{3.0, 1.0}, 0.3}};
+        std::vector<collision_detector::Gatherer> gatherers{{{0.0, 0.0}, {10.0, 0.0}, gatherer_width},
+                                                            {{3.0, -1.0}, {3.0, 1.5}, gatherer_width}};
+
+        WHEN("events are searched by arrays and by provider") {
+            auto events = FindGatherEvents(std::span<const Item>(items), std::span<const Gatherer>(gatherers));
+            auto reference = FindGatherEvents(TestItemGathererProvader{items, gatherers});
+
+            THEN("the same events are found") {
+                CHECK(events.size() == 3);
+                CHECK(std::equal(reference.begin(), reference.end(), events.begin(), events.end(), are_equal_events));
+            }
+        }
+    }
+}
+
+SCENARIO("Static items are indexed once") {
+    GIVEN("dynamic items and a prebuilt grid of static items") {
+        std::vector<collision_detector::Item> items{{{1.0, 0.0}, item_width}, {{3.0, 0.2}, item_width}};
+        std::vector<collision_detector::Item> static_items{{{2.0, 0.0}, 0.3}, {{2.0, 5.0}, 0.3}};
+        std::vector<collision_detector::Gatherer> gatherers{{{0.0, 0.0}, {4.0, 0.0}, gatherer_width}};
+        const ItemGrid static_grid(static_items);
+
+        WHEN("events are searched") {
+            auto events = FindGatherEvents(items, static_grid, gatherers);
+
+            THEN("static items follow dynamic items in id order") {
+                std::vector<collision_detector::Item> all_items = items;
+                all_items.insert(all_items.end(), static_items.begin(), static_items.end());
+                auto reference = FindGatherEvents(TestItemGathererProvader{all_items, gatherers});
+
+                REQUIRE(events.size() == 3);
+                CHECK(events[1].item_id == 2);
+                CHECK(std::equal(reference.begin(), reference.end(), events.begin(), events.end(), are_equal_events));
+            }
+        }
+    }
+}
+
+SCENARIO("Batch collection matches single point collection") {
+    GIVEN("points which count is not a multiple of vector width") {
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<double> coord(-20.0, 20.0);
+        const geom::Point2D start{-3.5, 1.25};
+        const geom::Point2D end{8.0, -2.75};
+
+        std::vector<double> xs(37);
+        std::vector<double> ys(37);
+        for (size_t i = 0; i < xs.size(); ++i) {
+            xs[i] = coord(generator);
+            ys[i] = coord(generator);
+        }
+
+        WHEN("points are processed by both kernels") {
+            std::vector<double> scalar_sq_distances(xs.size());
+            std::vector<double> scalar_proj_ratios(xs.size());
+            std::vector<double> simd_sq_distances(xs.size());
+            std::vector<double> simd_proj_ratios(xs.size());
+
+            TryCollectPoints(start, end, xs, ys, scalar_sq_distances, scalar_proj_ratios, CollectKernel::SCALAR);
+            TryCollectPoints(start, end, xs, ys, simd_sq_distances, simd_proj_ratios, CollectKernel::SIMD);
+
+            THEN("results are equal to TryCollectPoint for every point") {
+                for (size_t i = 0; i < xs.size(); ++i) {
+                    const auto expected = TryCollectPoint(start, end, {xs[i], ys[i]});
+
+                    CHECK(scalar_sq_distances[i] == expected.sq_distance);
+                    CHECK(scalar_proj_ratios[i] == expected.proj_ratio);
+                    CHECK(simd_sq_distances[i] == expected.sq_distance);
+                    CHECK(simd_proj_ratios[i] == expected.proj_ratio);
+                }
+            }
+        }
+    }
+}
+
 }  // namespace Catch
\ No newline at end of file
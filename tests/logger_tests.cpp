@@ -0,0 +1,195 @@
+#include <boost/core/null_deleter.hpp>
+#include <boost/json/parse.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/text_ostream_backend.hpp>
+#include <boost/log/utility/setup/common_attributes.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../src/game_server/server/logger.h"
+
+using namespace std::literals;
+
+namespace {
+namespace sinks = boost::log::sinks;
+
+std::vector<std::string> SplitLines(const std::string& text) {
+    std::vector<std::string> lines;
+    std::istringstream input(text);
+
+    for(std::string line; std::getline(input, line);) {
+        lines.push_back(line);
+    }
+
+    return lines;
+}
+
+//Направляет записи журнала в строку на время своей жизни
+class LogCapture {
+public:
+    LogCapture() {
+        boost::log::add_common_attributes();
+
+        auto backend = boost::make_shared<sinks::text_ostream_backend>();
+        backend->add_stream(boost::shared_ptr<std::ostream>(&stream_, boost::null_deleter()));
+        backend->auto_flush(true);
+
+        sink_ = boost::make_shared<sinks::synchronous_sink<sinks::text_ostream_backend>>(backend);
+        sink_->set_formatter(&logger::MyFormatter);
+        boost::log::core::get()->add_sink(sink_);
+    }
+
+    LogCapture(const LogCapture&) = delete;
+    LogCapture& operator=(const LogCapture&) = delete;
+
+    ~LogCapture() {
+        boost::log::core::get()->remove_sink(sink_);
+    }
+
+    std::vector<std::string> GetLines() const {
+        return SplitLines(stream_.str());
+    }
+private:
+    std::ostringstream stream_;
+    boost::shared_ptr<sinks::synchronous_sink<sinks::text_ostream_backend>> sink_;
+};
+
+//Асинхронный журнал пишет в std::cout, поэтому перехватывается сам поток
+class CoutCapture {
+public:
+    CoutCapture()
+        : old_buf_(std::cout.rdbuf(stream_.rdbuf())) {
+    }
+
+    CoutCapture(const CoutCapture&) = delete;
+    CoutCapture& operator=(const CoutCapture&) = delete;
+
+    ~CoutCapture() {
+        std::cout.rdbuf(old_buf_);
+    }
+
+    std::vector<std::string> GetLines() const {
+        return SplitLines(stream_.str());
+    }
+private:
+    std::ostringstream stream_;
+    std::streambuf* old_buf_;
+};
+
+boost::json::object ParseLine(const std::string& line) {
+    return boost::json::parse(line).as_object();
+}
+}//namespace
+
+SCENARIO("Log line format", "[Server]") {
+    logger::SetResponseSampling(1);
+    LogCapture capture;
+
+    GIVEN("request with special characters in URI") {
+        const std::string uri = "/api/v1/maps/\"quoted\"\\path\n\t\x01\x1f"s;
+        logger::LogRequest("127.0.0.1"sv, uri, "GET"sv);
+
+        THEN("line is valid JSON with the original value") {
+            auto lines = capture.GetLines();
+            REQUIRE(lines.size() == 1);
+
+            auto record = ParseLine(lines.front());
+            CHECK(record.at("message").as_string() == "request received");
+            CHECK(record.contains("timestamp"));
+
+            const auto& data = record.at("data").as_object();
+            CHECK(data.at("URI").as_string() == uri);
+            CHECK(data.at("ip").as_string() == "127.0.0.1");
+            CHECK(data.at("method").as_string() == "GET");
+        }
+    }
+
+    GIVEN("response") {
+        logger::LogResponse(15, 200, "application/json"sv);
+
+        THEN("numbers are written as numbers") {
+            auto lines = capture.GetLines();
+            REQUIRE(lines.size() == 1);
+
+            const auto& data = ParseLine(lines.front()).at("data").as_object();
+            CHECK(data.at("response_time").as_int64() == 15);
+            CHECK(data.at("code").as_int64() == 200);
+            CHECK(data.at("content_type").as_string() == "application/json");
+        }
+    }
+
+    GIVEN("execution record") {
+        logger::LogExecution(boost::json::object{{"port", 8080}}, "server started"sv);
+
+        THEN("it has the same layout") {
+            auto lines = capture.GetLines();
+            REQUIRE(lines.size() == 1);
+
+            auto record = ParseLine(lines.front());
+            CHECK(record.at("message").as_string() == "server started");
+            CHECK(record.at("data").as_object().at("port").as_int64() == 8080);
+        }
+    }
+}
+
+SCENARIO("Response sampling", "[Server]") {
+    LogCapture capture;
+    logger::SetResponseSampling(3, 100);
+
+    WHEN("fast successful responses are logged") {
+        for(int i = 0; i < 9; ++i) {
+            logger::LogResponse(1, 200, "application/json"sv);
+        }
+
+        THEN("every third one is written") {
+            CHECK(capture.GetLines().size() == 3);
+        }
+    }
+
+    WHEN("errors and slow responses are logged") {
+        for(int i = 0; i < 5; ++i) {
+            logger::LogResponse(1, 404, "application/json"sv);
+        }
+        for(int i = 0; i < 4; ++i) {
+            logger::LogResponse(100, 200, "application/json"sv);
+        }
+
+        THEN("all of them are written") {
+            CHECK(capture.GetLines().size() == 9);
+        }
+    }
+
+    logger::SetResponseSampling(1);
+}
+
+SCENARIO("Asynchronous log", "[Server]") {
+    boost::log::add_common_attributes();
+    logger::SetResponseSampling(1);
+
+    GIVEN("async log blocking on overflow") {
+        const size_t count = 20000;
+        CoutCapture capture;
+
+        WHEN("more records than the queue holds are written") {
+            logger::StartAsyncLog(logger::OverflowPolicy::BLOCK);
+            for(size_t i = 0; i < count; ++i) {
+                logger::LogRequest("127.0.0.1"sv, "/api/v1/maps/"s + std::to_string(i), "GET"sv);
+            }
+            logger::StopAsyncLog();
+
+            THEN("every record is written in order after stop") {
+                auto lines = capture.GetLines();
+                REQUIRE(lines.size() == count);
+                CHECK(ParseLine(lines.front()).at("data").as_object().at("URI").as_string() == "/api/v1/maps/0");
+                CHECK(ParseLine(lines.back()).at("data").as_object().at("URI").as_string()
+                      == "/api/v1/maps/" + std::to_string(count - 1));
+            }
+        }
+    }
+}
\ No newline at end of file
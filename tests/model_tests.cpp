@@ -1,6 +1,8 @@
 #include <boost/json/array.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <list>
 #include <iostream>
@@ -135,8 +137,8 @@ SCENARIO("Model", "[Model]") {
         AND_WHEN("added dogs have a bag"){
 
             THEN("dog bag capacity equal capacity per map bag capacity info"){
-                CHECK(parameters_map1.dog->GetBagCapacity() == 5);
-                CHECK(parameters_town.dog->GetBagCapacity() == 4);
+                CHECK(parameters_map1.dog.GetBagCapacity() == 5);
+                CHECK(parameters_town.dog.GetBagCapacity() == 4);
             }
 
             AND_THEN("bag can be filled loot") {
@@ -145,14 +147,14 @@ SCENARIO("Model", "[Model]") {
                                                {next_id++, 1, 50, {1.1, 1.1}}};
 
                 for(const auto& obj : loot) {
-                    parameters_map1.dog->TryPickUpLoot(obj);
+                    parameters_map1.dog.TryPickUpLoot(obj);
                 }
-                CHECK(parameters_map1.dog->GetBag().size() == 2);
+                CHECK(parameters_map1.dog.GetBag().size() == 2);
                 
                 THEN("loot can be taken out of the bag and score grows by cost of loot"){
-                    parameters_map1.dog->LayOutLoot();
-                    CHECK(parameters_map1.dog->GetBag().size() == 0);
-                    CHECK(parameters_map1.dog->GetScore() == 100);
+                    parameters_map1.dog.LayOutLoot();
+                    CHECK(parameters_map1.dog.GetBag().size() == 0);
+                    CHECK(parameters_map1.dog.GetScore() == 100);
                 }
             }
         }
@@ -166,13 +168,13 @@ SCENARIO("Model", "[Model]") {
                                            {next_id++, 1, 50, {4.4, 4.4}},
                                            {next_id++, 1, 50, {5.5, 5.5}}};
 
-            for(size_t i = 0; i < parameters_map1.dog->GetBagCapacity(); ++i) {
-                parameters_map1.dog->TryPickUpLoot(loot[i]);
+            for(size_t i = 0; i < parameters_map1.dog.GetBagCapacity(); ++i) {
+                parameters_map1.dog.TryPickUpLoot(loot[i]);
             }
 
             THEN("loot is not picked up") {
-                parameters_map1.dog->TryPickUpLoot(loot.back());
-                CHECK(parameters_map1.dog->GetBag().size() == parameters_map1.dog->GetBagCapacity());
+                parameters_map1.dog.TryPickUpLoot(loot.back());
+                CHECK(parameters_map1.dog.GetBag().size() == parameters_map1.dog.GetBagCapacity());
             }
         }
 
@@ -188,9 +190,384 @@ SCENARIO("Model", "[Model]") {
             AND_THEN("it can't be picked up by another players") {
                 //Имитируем взятие лута другим игроком
                 loot.front().MarkPikedUp();
-                parameters_map1.dog->TryPickUpLoot(loot.front());
-                CHECK(parameters_map1.dog->GetBag().size() == 0);
+                parameters_map1.dog.TryPickUpLoot(loot.front());
+                CHECK(parameters_map1.dog.GetBag().size() == 0);
             }
         }           
     }
-}
\ No newline at end of file
+}
+
+SCENARIO("Loot gathering during tick", "[Model]") {
+    using namespace std::literals;
+
+    model::Map map(model::Map::Id("map"s), "Map"s);
+    map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 10));
+    map.AddRoad(model::Road(model::Road::VERTICAL, {0, 0}, 10));
+    map.AddOffice(model::Office(model::Office::Id("office"s), {8, 0}, {0, 0}));
+    map.SetDogSpeed(1.);
+    map.SetBagCapacity(3);
+    map.SerLootUnitCost(10);
+    map.SerLootUnitCost(30);
+
+    model::GameSession session(loot_gen::LootGenerator(1s, 0.), map);
+
+    GIVEN("a dog moving along the road with loot on its way") {
+        auto dog = session.AddDog("Bob"s, false);
+        dog.UpdateState({2., 0.}, model::Direction::R);
+        session.AddLostObjects({model::Loot(0, 0, 10, {3., 0.})});
+
+        WHEN("the dog passes the loot") {
+            session.MoveUnits(2000ms);
+
+            THEN("loot is in the bag and removed from the map") {
+                CHECK(dog.GetBag().size() == 1);
+                CHECK(session.GetLoot().empty());
+                CHECK(dog.GetScore() == 0);
+            }
+
+            AND_WHEN("the dog passes the office") {
+                session.MoveUnits(2500ms);
+
+                THEN("loot is delivered and score grows by its cost") {
+                    CHECK(dog.GetBag().empty());
+                    CHECK(dog.GetScore() == 10);
+                }
+            }
+        }
+
+        WHEN("the dog passes the loot and the office during one tick") {
+            session.MoveUnits(4500ms);
+
+            THEN("loot is picked up before delivery") {
+                CHECK(dog.GetBag().empty());
+                CHECK(session.GetLoot().empty());
+                CHECK(dog.GetScore() == 10);
+            }
+        }
+    }
+
+    GIVEN("several dogs moving along different roads") {
+        auto horizontal_dog = session.AddDog("Bob"s, false);
+        auto vertical_dog = session.AddDog("Tom"s, false);
+        auto staying_dog = session.AddDog("Poll"s, false);
+
+        horizontal_dog.UpdateState({2., 0.}, model::Direction::R);
+        vertical_dog.UpdateState({0., 2.}, model::Direction::D);
+        session.AddLostObjects({model::Loot(0, 0, 10, {3., 0.}),
+                                model::Loot(1, 1, 30, {0., 3.})});
+
+        WHEN("dogs are moved during one tick") {
+            session.MoveUnits(2000ms);
+
+            THEN("every dog gathers only loot on its own way") {
+                REQUIRE(horizontal_dog.GetBag().size() == 1);
+                CHECK(horizontal_dog.GetBag().front().GetId() == 0);
+                REQUIRE(vertical_dog.GetBag().size() == 1);
+                CHECK(vertical_dog.GetBag().front().GetId() == 1);
+                CHECK(staying_dog.GetBag().empty());
+                CHECK(session.GetLoot().empty());
+            }
+        }
+    }
+}
+
+SCENARIO("Reproducible random generation", "[Model]") {
+    using namespace std::literals;
+    extra_data::LootTypes loot_types;
+    model::Map::Id map1_id = model::Map::Id("map1");
+
+    GIVEN("two games with the same random seed") {
+        auto make_session = [&] {
+            model::Game game = json_loader::LoadGame("../tests/test_data/config.json", loot_types, true);
+            game.SetRandomSeed(2024);
+
+            for(const auto& name : {"Bob"s, "John"s, "Nick"s}) {
+                game.PrepareUnitParameters(map1_id, name);
+            }
+            auto session = game.GetSessions()[0];
+            session->GenerateLoot(10000ms);
+
+            return std::pair{std::move(game), session};
+        };
+
+        auto [game1, session1] = make_session();
+        auto [game2, session2] = make_session();
+
+        THEN("dogs spawn at the same positions") {
+            REQUIRE(session1->GetDogs().size() == session2->GetDogs().size());
+            for(size_t i = 0; i < session1->GetDogs().size(); ++i) {
+                CHECK(session1->GetDogs().GetCoord(i) == session2->GetDogs().GetCoord(i));
+            }
+        }
+
+        AND_THEN("the same loot is generated") {
+            CHECK(session1->GetLoot() == session2->GetLoot());
+        }
+    }
+}
+
+SCENARIO("Search of roads containing point", "[Model]") {
+    using namespace std::literals;
+
+    model::Map map(model::Map::Id("map"s), "Map"s);
+    map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 10));
+    map.AddRoad(model::Road(model::Road::HORIZONTAL, {10, 5}, 0));
+    map.AddRoad(model::Road(model::Road::VERTICAL, {0, 0}, 5));
+    map.AddRoad(model::Road(model::Road::VERTICAL, {10, 5}, 0));
+
+    THEN("every road has exactly one orientation") {
+        for(const auto& road : map.GetRoads()) {
+            CHECK(road.IsVertical() != road.IsHorizontal());
+        }
+        CHECK(map.GetRoads()[2].IsVertical());
+
+        //Дорога нулевой длины считается горизонтальной
+        model::Road point_road(model::Road::VERTICAL, {3, 3}, 3);
+        CHECK(point_road.IsHorizontal());
+        CHECK_FALSE(point_road.IsVertical());
+    }
+
+    WHEN("point lies on a single road") {
+        auto roads = map.FindCandidateRoads({4.2, 0.3});
+
+        THEN("only this road is found") {
+            REQUIRE(roads.size() == 1);
+            CHECK(roads.front() == &map.GetRoads()[0]);
+        }
+    }
+
+    WHEN("point lies on a crossroad") {
+        auto roads = map.FindCandidateRoads({10.3, 4.7});
+
+        THEN("both crossing roads are found") {
+            REQUIRE(roads.size() == 2);
+            CHECK(std::count(roads.begin(), roads.end(), &map.GetRoads()[1]) == 1);
+            CHECK(std::count(roads.begin(), roads.end(), &map.GetRoads()[3]) == 1);
+        }
+    }
+
+    WHEN("point lies outside of roads") {
+        THEN("no roads are found") {
+            CHECK(map.FindCandidateRoads({5., 2.5}).empty());
+            CHECK(map.FindCandidateRoads({-0.5, 0.}).empty());
+            CHECK(map.FindCandidateRoads({5., -0.41}).empty());
+        }
+    }
+}
+
+
+SCENARIO("Dog handles in game session", "[Model]") {
+    using namespace std::literals;
+
+    model::Map map(model::Map::Id("map"s), "Map"s);
+    map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 10));
+    map.SetDogSpeed(1.);
+    map.SetBagCapacity(3);
+    map.SerLootUnitCost(10);
+
+    model::GameSession session(loot_gen::LootGenerator(1s, 0.), map);
+
+    GIVEN("several dogs in session") {
+        auto first_dog = session.AddDog("Bob"s, false);
+        auto second_dog = session.AddDog("Tom"s, false);
+        auto third_dog = session.AddDog("Poll"s, false);
+
+        third_dog.UpdateState({1., 0.}, model::Direction::R);
+
+        WHEN("other dogs are deleted") {
+            session.DeleteDog(first_dog.GetId());
+            session.DeleteDog(second_dog.GetId());
+
+            THEN("handle still refers to its dog") {
+                CHECK(session.GetDogs().size() == 1);
+                CHECK(third_dog.GetName() == "Poll"s);
+                CHECK(third_dog.GetDirection() == model::Direction::R);
+            }
+
+            AND_WHEN("units are moved") {
+                session.MoveUnits(1000ms);
+
+                THEN("state of dog is available through handle") {
+                    CHECK((third_dog.GetCoord() == model::CoordObject{1., 0.}));
+                    CHECK((third_dog.GetPrevCoord() == model::CoordObject{0., 0.}));
+                    CHECK(third_dog.GetTimeInGame() == 1000ms);
+                    CHECK(third_dog.GetInactiveTime() == 0ms);
+                }
+            }
+
+            AND_THEN("handle of deleted dog can't be used") {
+                CHECK_THROWS(second_dog.GetName());
+            }
+        }
+
+        WHEN("dog is searched by id") {
+            THEN("only dogs of session are found") {
+                REQUIRE(session.FindDog(second_dog.GetId()));
+                CHECK(session.FindDog(second_dog.GetId())->GetName() == "Tom"s);
+                CHECK_FALSE(session.FindDog(3));
+            }
+        }
+    }
+}
+
+SCENARIO("Session snapshots", "[Model]") {
+    using namespace std::literals;
+
+    model::Map map(model::Map::Id("map"s), "Map"s);
+    map.AddRoad(model::Road(model::Road::HORIZONTAL, {0, 0}, 10));
+    map.SetDogSpeed(1.);
+    map.SetBagCapacity(3);
+    map.SerLootUnitCost(10);
+
+    model::GameSession session(loot_gen::LootGenerator(1s, 0.), map);
+
+    GIVEN("a new session") {
+        THEN("empty snapshot is already published") {
+            REQUIRE(session.GetSnapshot());
+            CHECK(session.GetSnapshot()->dogs.empty());
+            CHECK(session.GetSnapshot()->lost_objects.empty());
+        }
+    }
+
+    GIVEN("a dog in session") {
+        auto dog = session.AddDog("Bob"s, false);
+
+        //Новая собака видна читателям только после публикации
+        CHECK(session.GetSnapshot()->dogs.empty());
+        REQUIRE(session.PublishSnapshotIfChanged());
+        auto snapshot = session.GetSnapshot();
+
+        REQUIRE(snapshot->dogs.size() == 1);
+
+        WHEN("nothing is changed") {
+            THEN("snapshot isn't published again") {
+                CHECK_FALSE(session.PublishSnapshotIfChanged());
+                CHECK(session.GetSnapshot() == snapshot);
+            }
+        }
+
+        WHEN("several changes are made") {
+            dog.UpdateState({1., 0.}, model::Direction::R);
+            session.MarkChanged();
+            session.AddDog("Tom"s, false);
+
+            THEN("they are published by one snapshot") {
+                CHECK(session.PublishSnapshotIfChanged());
+                CHECK_FALSE(session.PublishSnapshotIfChanged());
+                CHECK(session.GetSnapshot()->dogs.size() == 2);
+                CHECK(session.GetSnapshot()->version == snapshot->version + 1);
+            }
+        }
+
+        WHEN("tick is processed") {
+            dog.UpdateState({1., 0.}, model::Direction::R);
+            session.ProcessTickActions(1000ms);
+            session.PublishSnapshotIfChanged();
+
+            THEN("new snapshot contains current state") {
+                const auto& dogs = session.GetSnapshot()->dogs;
+                REQUIRE(dogs.size() == 1);
+                CHECK((dogs.GetCoord(0) == model::CoordObject{1., 0.}));
+            }
+
+            AND_THEN("previously taken snapshot is unchanged") {
+                CHECK((snapshot->dogs.GetCoord(0) == model::CoordObject{0., 0.}));
+                CHECK(snapshot->dogs.GetSpeed(0).horizontal == 0.);
+            }
+        }
+
+        WHEN("cached body is requested several times") {
+            int builds = 0;
+            auto build = [&builds] {
+                ++builds;
+                return "body"s;
+            };
+
+            THEN("it is built once per snapshot") {
+                CHECK(snapshot->state_body.Get(build) == "body"s);
+                CHECK(snapshot->state_body.Get(build) == "body"s);
+                CHECK(builds == 1);
+
+                session.ProcessTickActions(100ms);
+                session.PublishSnapshotIfChanged();
+                CHECK(session.GetSnapshot()->state_body.Get(build) == "body"s);
+                CHECK(builds == 2);
+            }
+        }
+
+        WHEN("dog is deleted") {
+            session.DeleteDog(dog.GetId());
+            session.PublishSnapshotIfChanged();
+
+            THEN("snapshot doesn't contain it") {
+                CHECK(session.GetSnapshot()->dogs.empty());
+                CHECK(snapshot->dogs.size() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("Loot store", "[Model]") {
+    GIVEN("store with several loot items") {
+        model::LootStore store;
+        store.Add(model::Loot(0, 0, 10, {0., 0.}));
+        store.Add(model::Loot(1, 1, 20, {1., 0.}));
+        store.Add(model::Loot(2, 0, 10, {2., 0.}));
+
+        WHEN("item is removed from the middle") {
+            CHECK(store.Remove(1));
+
+            THEN("other items are still found by id") {
+                CHECK(store.size() == 2);
+                CHECK(store.Find(1) == nullptr);
+                REQUIRE(store.Find(0) != nullptr);
+                CHECK((store.Find(0)->GetPosition() == model::CoordObject{0., 0.}));
+                REQUIRE(store.Find(2) != nullptr);
+                CHECK((store.Find(2)->GetPosition() == model::CoordObject{2., 0.}));
+            }
+
+            AND_THEN("item can't be removed twice") {
+                CHECK_FALSE(store.Remove(1));
+            }
+        }
+
+        WHEN("item with existing id is added") {
+            THEN("exception is thrown") {
+                CHECK_THROWS_AS(store.Add(model::Loot(1, 0, 10, {0., 0.})), std::invalid_argument);
+                CHECK(store.size() == 3);
+            }
+        }
+    }
+}
+
+SCENARIO("Road bounds checks benchmark", "[.][benchmark]") {
+    std::vector<model::Road> roads{model::Road(model::Road::HORIZONTAL, {0, 0}, 40),
+                                   model::Road(model::Road::VERTICAL, {40, 30}, 0),
+                                   model::Road(model::Road::HORIZONTAL, {40, 30}, 0)};
+    std::vector<model::CoordObject> positions;
+    
+    for(int i = 0; i < 1024; ++i) {
+        positions.push_back({(i * 37 % 4200) / 100. - 1., (i * 53 % 4200) / 100. - 1.});
+    }
+
+    BENCHMARK("Road::Clamp") {
+        double sum = 0.;
+        for(const auto& road : roads) {
+            for(auto pos : positions) {
+                auto clamped = road.Clamp(pos);
+                sum += clamped.x + clamped.y;
+            }
+        }
+        return sum;
+    };
+
+    BENCHMARK("Road::IsCurrectPos") {
+        size_t count = 0;
+        for(const auto& road : roads) {
+            for(auto pos : positions) {
+                count += road.IsCurrectPos(pos);
+            }
+        }
+        return count;
+    };
+}
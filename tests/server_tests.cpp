@@ -0,0 +1,282 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../src/game_server/handlers/target_storage.h"
+#include "../src/game_server/server/etag.h"
+#include "../src/game_server/server/file_cache.h"
+#include "../src/game_server/server/http_range.h"
+#include "../src/game_server/server/metrics.h"
+#include "../src/game_server/server/tick_profiler.h"
+
+SCENARIO("ETag validators", "[Server]") {
+    using namespace std::literals;
+
+    GIVEN("an etag of content") {
+        const auto tag = etag::ComputeETag("content"sv);
+
+        THEN("it depends only on content") {
+            CHECK(tag == etag::ComputeETag("content"sv));
+            CHECK(tag != etag::ComputeETag("other content"sv));
+        }
+
+        THEN("it is matched by If-None-Match") {
+            CHECK(etag::MatchesIfNoneMatch(tag, tag));
+            CHECK(etag::MatchesIfNoneMatch("\"other\", W/"s + tag, tag));
+            CHECK(etag::MatchesIfNoneMatch("*"sv, tag));
+            CHECK_FALSE(etag::MatchesIfNoneMatch(""sv, tag));
+            CHECK_FALSE(etag::MatchesIfNoneMatch("\"other\""sv, tag));
+        }
+    }
+
+    GIVEN("version etags") {
+        THEN("they differ between versions and scopes") {
+            CHECK(etag::MakeVersionETag("map1"sv, 1) == etag::MakeVersionETag("map1"sv, 1));
+            CHECK(etag::MakeVersionETag("map1"sv, 1) != etag::MakeVersionETag("map1"sv, 2));
+            CHECK(etag::MakeVersionETag("map1"sv, 1) != etag::MakeVersionETag("town"sv, 1));
+        }
+    }
+
+    GIVEN("a file larger than one read block") {
+        const auto tmp_path = std::filesystem::temp_directory_path() / "etag_large_file.bin";
+        std::string content;
+        for(size_t i = 0; i < 200000; ++i) {
+            content += static_cast<char>(i * 31);
+        }
+        std::ofstream(tmp_path, std::ios::binary) << content;
+
+        THEN("its etag is the etag of the whole content") {
+            etag::FileETagCache cache;
+            CHECK(cache.GetETag(tmp_path) == etag::ComputeETag(content));
+        }
+        std::filesystem::remove(tmp_path);
+    }
+}
+
+SCENARIO("Static file cache", "[Server]") {
+    using namespace std::literals;
+    const std::string path = "../static/index.html"s;
+
+    GIVEN("a cache with enough memory") {
+        file_cache::FileCache cache(1024 * 1024);
+
+        WHEN("file is loaded") {
+            auto file = cache.Load(path);
+            REQUIRE(file);
+
+            THEN("it is read once and compressed") {
+                CHECK(cache.Load(path) == file);
+                REQUIRE(file->gzip_content);
+                CHECK(file->gzip_content->size() < file->content->size());
+                CHECK(file->etag != file->gzip_etag);
+                CHECK(cache.GetSize() == file->content->size() + file->gzip_content->size());
+            }
+        }
+
+        THEN("missing file is not cached") {
+            CHECK_FALSE(cache.Load("../static/missing.html"s));
+        }
+    }
+
+    GIVEN("a disabled or too small cache") {
+        THEN("files are not cached") {
+            CHECK_FALSE(file_cache::FileCache().Load(path));
+            CHECK_FALSE(file_cache::FileCache(16).Load(path));
+        }
+    }
+
+    GIVEN("a cache that fits the file but not its compressed copy") {
+        const auto tmp_path = std::filesystem::temp_directory_path() / "file_cache_rejected.txt";
+        std::ofstream(tmp_path) << std::string(1000, 'a');
+        file_cache::FileCache cache(1010);
+
+        WHEN("file is rejected") {
+            REQUIRE_FALSE(cache.Load(tmp_path));
+
+            THEN("rejection is remembered and the file is not read again") {
+                //Уменьшенный файл поместился бы, но кэш уже отказал по этому пути
+                std::ofstream(tmp_path) << "a";
+                CHECK_FALSE(cache.Load(tmp_path));
+                CHECK(cache.GetSize() == 0);
+            }
+        }
+        std::filesystem::remove(tmp_path);
+    }
+
+    GIVEN("Accept-Encoding values") {
+        THEN("gzip is negotiated") {
+            CHECK(file_cache::AcceptsGzip("gzip, deflate, br"sv));
+            CHECK(file_cache::AcceptsGzip("br;q=1.0, gzip;q=0.5"sv));
+            CHECK(file_cache::AcceptsGzip("*"sv));
+            CHECK_FALSE(file_cache::AcceptsGzip("gzip;q=0"sv));
+            CHECK_FALSE(file_cache::AcceptsGzip("deflate"sv));
+            CHECK_FALSE(file_cache::AcceptsGzip(""sv));
+        }
+    }
+}
+
+SCENARIO("Byte ranges", "[Server]") {
+    using namespace std::literals;
+    using http_range::ByteRange;
+    using http_range::RangeStatus;
+
+    GIVEN("a resource of 100 bytes") {
+        const std::uint64_t size = 100;
+
+        THEN("single ranges are clamped to the resource") {
+            auto range = http_range::ParseRange("bytes=10-19"sv, size);
+            REQUIRE(range.status == RangeStatus::SATISFIABLE);
+            CHECK(range.ranges == http_range::Ranges{ByteRange{10, 19}});
+
+            CHECK(http_range::ParseRange("bytes=90-500"sv, size).ranges == http_range::Ranges{ByteRange{90, 99}});
+            CHECK(http_range::ParseRange("bytes=95-"sv, size).ranges == http_range::Ranges{ByteRange{95, 99}});
+            CHECK(http_range::ParseRange("bytes=-10"sv, size).ranges == http_range::Ranges{ByteRange{90, 99}});
+        }
+
+        THEN("overlapping ranges are coalesced") {
+            auto range = http_range::ParseRange("bytes=50-59, 0-9, 5-14"sv, size);
+            REQUIRE(range.status == RangeStatus::SATISFIABLE);
+            CHECK(range.ranges == http_range::Ranges{ByteRange{0, 14}, ByteRange{50, 59}});
+        }
+
+        THEN("invalid headers are ignored and ranges past the end are not satisfiable") {
+            CHECK(http_range::ParseRange(""sv, size).status == RangeStatus::NONE);
+            CHECK(http_range::ParseRange("items=0-9"sv, size).status == RangeStatus::NONE);
+            CHECK(http_range::ParseRange("bytes=9-0"sv, size).status == RangeStatus::NONE);
+            CHECK(http_range::ParseRange("bytes=100-"sv, size).status == RangeStatus::NOT_SATISFIABLE);
+        }
+
+        WHEN("several ranges are requested") {
+            const std::string content(size, 'a');
+            auto range = http_range::ParseRange("bytes=0-9, 90-99"sv, size);
+            auto partial = http_range::MakePartialContent(range.ranges, "text/plain"sv, size);
+
+            THEN("multipart body contains every part") {
+                CHECK(partial.content_type.starts_with("multipart/byteranges"sv));
+                CHECK_FALSE(partial.content_range);
+
+                const auto body = http_range::AssembleBody(partial, content);
+                CHECK(body.find("bytes 0-9/100"sv) != std::string::npos);
+                CHECK(body.find("bytes 90-99/100"sv) != std::string::npos);
+                CHECK(body.ends_with("--\r\n"sv));
+            }
+        }
+    }
+
+    GIVEN("an etag of file") {
+        const auto tag = etag::ComputeETag("content"sv);
+
+        THEN("If-Range requires the same strong etag") {
+            CHECK(etag::MatchesIfRange(""sv, tag));
+            CHECK(etag::MatchesIfRange(tag, tag));
+            CHECK_FALSE(etag::MatchesIfRange("W/"s + tag, tag));
+            CHECK_FALSE(etag::MatchesIfRange("Wed, 21 Oct 2015 07:28:00 GMT"sv, tag));
+        }
+    }
+}
+
+SCENARIO("Server metrics", "[Server]") {
+    using namespace std::literals;
+
+    GIVEN("histogram") {
+        metrics::Histogram histogram({1., 5.});
+
+        WHEN("values are observed") {
+            histogram.Observe(0.5);
+            histogram.Observe(1.);
+            histogram.Observe(3.);
+            histogram.Observe(10.);
+
+            THEN("buckets are cumulative") {
+                auto snapshot = histogram.Collect();
+
+                CHECK(snapshot.buckets == std::vector<uint64_t>{2, 3, 4});
+                CHECK(snapshot.count == 4);
+                CHECK(snapshot.sum == 14.5);
+            }
+        }
+    }
+
+    GIVEN("bounds that do not fit into a shard") {
+        THEN("histogram is not created") {
+            CHECK_THROWS_AS(metrics::Histogram(std::vector<double>(metrics::Histogram::MAX_BUCKETS_COUNT, 1.)),
+                            std::invalid_argument);
+            CHECK_NOTHROW(metrics::Histogram(std::vector<double>(metrics::Histogram::MAX_BUCKETS_COUNT - 1, 1.)));
+        }
+    }
+
+    GIVEN("server metrics") {
+        metrics::ServerMetrics server_metrics;
+        auto& session = server_metrics.AddSession("map1"s);
+
+        WHEN("request and tick are observed") {
+            server_metrics.ObserveRequest(targets_storage::TargetRequestType::GET_MAPS_INFO, 2ms);
+            session.dogs.Set(3);
+
+            THEN("they are rendered with labels") {
+                auto text = server_metrics.Render();
+
+                CHECK(text.find("game_server_request_duration_seconds_count{type=\"get_maps_info\"} 1\n"s) != text.npos);
+                CHECK(text.find("game_server_session_dogs{map=\"map1\"} 3\n"s) != text.npos);
+                CHECK(text.find("# TYPE game_server_tick_duration_seconds histogram\n"s) != text.npos);
+            }
+
+            AND_THEN("the same session is returned for the map") {
+                CHECK(&server_metrics.AddSession("map1"s) == &session);
+            }
+        }
+    }
+}
+
+SCENARIO("Tick profiler", "[Server]") {
+    using namespace std::literals;
+    using tick_profiler::Phase;
+
+    GIVEN("profiler with short history") {
+        tick_profiler::TickProfiler profiler(50ms, 2);
+        tick_profiler::PhasesDuration phases{};
+        phases[static_cast<size_t>(Phase::GENERATE_LOOT)] = 30ms;
+        phases[static_cast<size_t>(Phase::SET_RECORDS)] = 10ms;
+
+        WHEN("ticks are added") {
+            profiler.AddTick(50ms, 40ms, phases);
+            const auto& record = profiler.AddTick(50ms, 60ms, phases);
+            profiler.AddTick(50ms, 45ms, phases);
+
+            THEN("tick slower than period is overrun") {
+                CHECK(profiler.GetTicksCount() == 3);
+                CHECK(profiler.GetOverrunsCount() == 1);
+                CHECK(record.GetSlowestPhase() == Phase::GENERATE_LOOT);
+            }
+
+            AND_THEN("only last ticks are kept from old to new") {
+                auto history = profiler.GetHistory();
+
+                REQUIRE(history.size() == 2);
+                CHECK(history[0].number == 2);
+                CHECK(history[0].overrun);
+                CHECK(history[1].number == 3);
+                CHECK_FALSE(history[1].overrun);
+            }
+        }
+    }
+
+    GIVEN("profiler of manual ticks") {
+        tick_profiler::TickProfiler profiler(0ms);
+
+        WHEN("long tick is added") {
+            profiler.AddTick(1000ms, 2s, {});
+
+            THEN("it isn't overrun") {
+                CHECK(profiler.GetOverrunsCount() == 0);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <boost/archive/text_oarchive.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 #include <iostream>
@@ -162,7 +163,7 @@ SCENARIO_METHOD(Fixture, "GameSession serialization"s) {
 
                 //Проверяем корректность присвоения id. Было 2 собаки с id 0 и 1 
                 const auto dog = rest_session->AddDog("Pluto"s, true);
-                CHECK(dog->GetId() == 2);
+                CHECK(dog.GetId() == 2);
 
                 //Проверяем корректность присвоения id. Было 2 единицы лута с id 0 и 1
                 rest_session->GenerateLoot(10000ms);
@@ -238,3 +239,38 @@ SCENARIO_METHOD(Fixture, "ApplicationState serialization"s) {
         }
     }
 }
+
+
+SCENARIO("ApplicationState collected by sessions"s) {
+    app::Application application;
+    extra_data::LootTypes types;
+    application.SetGame(json_loader::LoadGame("../tests/test_data/config _with_capacity.json"s, types, true));
+    application.JoinGame("{\"userName\": \"Scooby Doo\", \"mapId\": \"map1\"}"s);
+    application.JoinGame("{\"userName\": \"Shaggy\", \"mapId\": \"town\"}"s);
+
+    GIVEN("An application with players on different maps"s) {
+        THEN("sessions are created for all maps"s) {
+            CHECK(application.GetSessions().size() == 2);
+        }
+
+        WHEN("state is collected session by session"s) {
+            serialization::ApplicationStateRepr repr;
+            for(const auto& session : application.GetSessions()) {
+                repr.AddGameSession(*session);
+                repr.AddPlayersData(application.GetPlayersData(session->GetMapId()));
+            }
+
+            THEN("it contains the same data as the whole state"s) {
+                auto state = application.GetApplicationState();
+                auto players = repr.RestorePlayersData();
+                auto expected_players = state.players;
+
+                std::sort(players.begin(), players.end());
+                std::sort(expected_players.begin(), expected_players.end());
+
+                CHECK(repr.RestoreGameSessionsRepr().size() == state.sessions.size());
+                CHECK(players == expected_players);
+            }
+        }
+    }
+}
@@ -0,0 +1,173 @@
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../src/game_server/handlers/ticker.h"
+
+namespace net = boost::asio;
+
+using namespace std::literals;
+using http_handler::TickPolicy;
+
+namespace {
+constexpr static std::chrono::milliseconds PERIOD = 20ms;
+//Второй тик обрабатывается дольше нескольких периодов
+constexpr static std::chrono::milliseconds STALL = 90ms;
+constexpr static std::size_t TICKS_COUNT = 8;
+
+struct TickLog {
+    std::vector<std::chrono::milliseconds> deltas;
+    //Наибольшее число тиков, выполненных подряд после одного срабатывания таймера
+    std::size_t max_steps = 0;
+    std::uint64_t observed_overruns = 0;
+    std::uint64_t overruns = 0;
+};
+
+TickLog RunTicker(TickPolicy policy, unsigned max_catch_up_steps = http_handler::DEFAULT_MAX_CATCH_UP_STEPS) {
+    net::io_context ioc;
+    auto strand = net::make_strand(ioc);
+    TickLog log;
+    //Следующий шаг догоняющего тика начинается внутри on_complete предыдущего
+    std::size_t depth = 0;
+
+    auto ticker = std::make_shared<http_handler::Ticker>(strand, PERIOD,
+                                                         [&](std::chrono::milliseconds delta, std::function<void()> on_complete) {
+        ++depth;
+        log.max_steps = std::max(log.max_steps, depth);
+        log.deltas.push_back(delta);
+
+        if(log.deltas.size() == 2) {
+            std::this_thread::sleep_for(STALL);
+        }
+        if(log.deltas.size() == TICKS_COUNT) {
+            ioc.stop();
+        }
+
+        on_complete();
+        --depth;
+    }, policy, max_catch_up_steps);
+
+    ticker->SetOverrunObserver([&log](std::uint64_t overruns) {
+        log.observed_overruns += overruns;
+    });
+    ticker->Start();
+    ioc.run_for(5s);
+
+    log.overruns = ticker->GetOverrunsCount();
+    return log;
+}
+
+bool AllEqual(const std::vector<std::chrono::milliseconds>& deltas, std::chrono::milliseconds value) {
+    return std::all_of(deltas.begin(), deltas.end(), [value](auto delta) {
+        return delta == value;
+    });
+}
+}//namespace
+
+SCENARIO("Ticker with stalled handler", "[Handlers]") {
+    //Обработчик занят STALL, поэтому пропускаются как минимум три срока
+    const std::uint64_t min_overruns = STALL / PERIOD - 1;
+
+    GIVEN("skip policy") {
+        auto log = RunTicker(TickPolicy::SKIP);
+
+        THEN("missed periods are dropped") {
+            REQUIRE(log.deltas.size() >= TICKS_COUNT);
+            CHECK(AllEqual(log.deltas, PERIOD));
+            CHECK(log.max_steps == 1);
+            CHECK(log.overruns >= min_overruns);
+        }
+
+        AND_THEN("observer gets every overrun") {
+            CHECK(log.observed_overruns == log.overruns);
+        }
+    }
+
+    GIVEN("catch up policy") {
+        WHEN("steps are limited") {
+            auto log = RunTicker(TickPolicy::CATCH_UP, 2);
+
+            THEN("missed periods are processed by at most max steps") {
+                REQUIRE(log.deltas.size() >= TICKS_COUNT);
+                CHECK(AllEqual(log.deltas, PERIOD));
+                CHECK(log.max_steps == 2);
+                CHECK(log.overruns >= min_overruns);
+                CHECK(log.observed_overruns == log.overruns);
+            }
+        }
+
+        WHEN("steps are enough for all missed periods") {
+            auto log = RunTicker(TickPolicy::CATCH_UP, 10);
+
+            THEN("every missed period is processed") {
+                REQUIRE(log.deltas.size() >= TICKS_COUNT);
+                CHECK(AllEqual(log.deltas, PERIOD));
+                CHECK(log.max_steps >= min_overruns + 1);
+            }
+        }
+    }
+
+    GIVEN("variable policy") {
+        auto log = RunTicker(TickPolicy::VARIABLE);
+
+        THEN("tick after stall lasts the whole stall") {
+            REQUIRE(log.deltas.size() >= TICKS_COUNT);
+            CHECK(*std::max_element(log.deltas.begin(), log.deltas.end()) >= STALL);
+            CHECK(log.max_steps == 1);
+            CHECK(log.overruns >= min_overruns);
+            CHECK(log.observed_overruns == log.overruns);
+        }
+    }
+}
+
+SCENARIO("Ticker with asynchronously completed tick", "[Handlers]") {
+    using Clock = http_handler::Ticker::Clock;
+    constexpr std::chrono::milliseconds period = 50ms;
+    //Тик завершается после следующего срока, но задолго до ещё одного
+    constexpr std::chrono::milliseconds stall = 60ms;
+
+    GIVEN("handler that completes the second tick after its deadline") {
+        net::io_context ioc;
+        auto strand = net::make_strand(ioc);
+        net::steady_timer stall_timer(strand);
+        std::size_t ticks = 0;
+        Clock::time_point completed_at;
+        std::chrono::milliseconds start_latency = 0ms;
+
+        auto ticker = std::make_shared<http_handler::Ticker>(strand, period,
+                                                             [&](std::chrono::milliseconds, std::function<void()> on_complete) {
+            ++ticks;
+            if(ticks == 2) {
+                stall_timer.expires_after(stall);
+                stall_timer.async_wait([&completed_at, on_complete](boost::system::error_code) {
+                    completed_at = Clock::now();
+                    on_complete();
+                });
+                return;
+            }
+            if(ticks == 3) {
+                start_latency = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - completed_at);
+                ioc.stop();
+            }
+            on_complete();
+        }, TickPolicy::SKIP);
+
+        ticker->Start();
+        ioc.run_for(5s);
+
+        THEN("missed period starts right after completion, not on the next timer firing") {
+            REQUIRE(ticks >= 3);
+            CHECK(start_latency < period / 5);
+            CHECK(ticker->GetOverrunsCount() >= 1);
+        }
+    }
+}
\ No newline at end of file